@@ -0,0 +1,229 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Nil Foundation <info@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_MARSHALLING_MERKLE_MULTIPROOF_HPP
+#define CRYPTO3_MARSHALLING_MERKLE_MULTIPROOF_HPP
+
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <nil/marshalling/types/bundle.hpp>
+#include <nil/marshalling/types/array_list.hpp>
+#include <nil/marshalling/types/integral.hpp>
+#include <nil/marshalling/status_type.hpp>
+#include <nil/marshalling/options.hpp>
+#include <nil/marshalling/field_type.hpp>
+
+#include <nil/crypto3/marshalling/containers/types/merkle_proof.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace marshalling {
+            namespace types {
+                // Several Merkle proofs with every distinct root and every distinct sibling node stored once,
+                // nodes in the fixed-size encoding.
+                // Sibling nodes are identified by (root, level, index in level) and stored in order of first
+                // appearance when walking the proofs in order, so the reader can replay the same walk.
+                template<typename TTypeBase, typename MerkleProof>
+                using merkle_multiproof = nil::marshalling::types::bundle<
+                    TTypeBase, std::tuple<
+                        // distinct roots
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            typename merkle_node_value_fixed<TTypeBase, MerkleProof>::type,
+                            nil::marshalling::option::sequence_size_field_prefix<
+                                nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >,
+                        // root index of every proof
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            nil::marshalling::types::integral<TTypeBase, std::uint64_t>,
+                            nil::marshalling::option::sequence_size_field_prefix<
+                                nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >,
+                        // leaf index of every proof
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            nil::marshalling::types::integral<TTypeBase, std::uint64_t>,
+                            nil::marshalling::option::sequence_size_field_prefix<
+                                nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >,
+                        // path length of every proof
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            nil::marshalling::types::integral<TTypeBase, std::uint64_t>,
+                            nil::marshalling::option::sequence_size_field_prefix<
+                                nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >,
+                        // distinct sibling nodes
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            typename merkle_node_value_fixed<TTypeBase, MerkleProof>::type,
+                            nil::marshalling::option::sequence_size_field_prefix<
+                                nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >
+                    >
+                >;
+
+                template<typename MerkleProof, typename Endianness>
+                merkle_multiproof<nil::marshalling::field_type<Endianness>, MerkleProof>
+                    fill_merkle_multiproof(const std::vector<MerkleProof> &proofs) {
+
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using uint64_t_marshalling_type = nil::marshalling::types::integral<TTypeBase, std::uint64_t>;
+                    using node_key_type = std::tuple<std::size_t, std::size_t, std::size_t>;
+                    constexpr std::size_t arity = MerkleProof::arity;
+
+                    merkle_multiproof<TTypeBase, MerkleProof> filled;
+                    auto &filled_roots = std::get<0>(filled.value()).value();
+                    auto &filled_root_indices = std::get<1>(filled.value()).value();
+                    auto &filled_leaf_indices = std::get<2>(filled.value()).value();
+                    auto &filled_path_lengths = std::get<3>(filled.value()).value();
+                    auto &filled_nodes = std::get<4>(filled.value()).value();
+                    filled_root_indices.reserve(proofs.size());
+                    filled_leaf_indices.reserve(proofs.size());
+                    filled_path_lengths.reserve(proofs.size());
+
+                    std::vector<typename MerkleProof::value_type> roots;
+                    std::map<node_key_type, const typename MerkleProof::value_type *> nodes;
+                    for (const auto &proof : proofs) {
+                        std::size_t root_index = 0;
+                        while (root_index < roots.size() && !(roots[root_index] == proof.root())) {
+                            root_index++;
+                        }
+                        if (root_index == roots.size()) {
+                            roots.push_back(proof.root());
+                            filled_roots.push_back(fill_merkle_node_value_fixed<MerkleProof, Endianness>(proof.root()));
+                        }
+                        filled_root_indices.push_back(uint64_t_marshalling_type(root_index));
+                        filled_leaf_indices.push_back(uint64_t_marshalling_type(proof.leaf_index()));
+                        filled_path_lengths.push_back(uint64_t_marshalling_type(proof.path().size()));
+
+                        std::size_t node_index = proof.leaf_index();
+                        for (std::size_t level = 0; level < proof.path().size(); level++, node_index /= arity) {
+                            const std::size_t group_begin = node_index - node_index % arity;
+                            for (std::size_t j = 0; j < arity - 1; j++) {
+                                const auto &path_element = proof.path()[level][j];
+                                if (path_element._position != merkle_proof_sibling_position<arity>(node_index, j)) {
+                                    throw std::invalid_argument(
+                                        "Merkle proof path element position does not match its leaf index");
+                                }
+                                const node_key_type key(root_index, level, group_begin + path_element._position);
+                                auto it = nodes.find(key);
+                                if (it == nodes.end()) {
+                                    nodes.emplace(key, &path_element._hash);
+                                    filled_nodes.push_back(
+                                        fill_merkle_node_value_fixed<MerkleProof, Endianness>(path_element._hash));
+                                } else if (!(*it->second == path_element._hash)) {
+                                    throw std::invalid_argument("Merkle proofs disagree on a node of the same tree");
+                                }
+                            }
+                        }
+                    }
+                    return filled;
+                }
+
+                // Trees are indexed by std::size_t leaf indices, so no valid path is longer.
+                constexpr static const std::size_t merkle_multiproof_max_path_length = 64;
+
+                template<typename MerkleProof, typename Endianness>
+                std::vector<MerkleProof> make_merkle_multiproof(
+                    const merkle_multiproof<nil::marshalling::field_type<Endianness>, MerkleProof> &filled) {
+
+                    using node_key_type = std::tuple<std::size_t, std::size_t, std::size_t>;
+                    constexpr std::size_t arity = MerkleProof::arity;
+
+                    const auto &filled_roots = std::get<0>(filled.value()).value();
+                    const auto &filled_root_indices = std::get<1>(filled.value()).value();
+                    const auto &filled_leaf_indices = std::get<2>(filled.value()).value();
+                    const auto &filled_path_lengths = std::get<3>(filled.value()).value();
+                    const auto &filled_nodes = std::get<4>(filled.value()).value();
+                    if (filled_leaf_indices.size() != filled_root_indices.size() ||
+                        filled_path_lengths.size() != filled_root_indices.size()) {
+                        throw std::invalid_argument("Merkle multiproof sizes mismatch");
+                    }
+
+                    std::vector<typename MerkleProof::value_type> roots;
+                    roots.reserve(filled_roots.size());
+                    for (const auto &filled_root : filled_roots) {
+                        roots.push_back(make_merkle_node_value_fixed<MerkleProof, Endianness>(filled_root));
+                    }
+
+                    std::vector<typename MerkleProof::value_type> nodes;
+                    nodes.reserve(filled_nodes.size());
+                    std::map<node_key_type, std::size_t> node_indices;
+                    std::vector<MerkleProof> proofs;
+                    proofs.reserve(filled_root_indices.size());
+                    for (std::size_t i = 0; i < filled_root_indices.size(); i++) {
+                        const std::size_t root_index = filled_root_indices[i].value();
+                        const std::size_t leaf_index = filled_leaf_indices[i].value();
+                        const std::size_t path_length = filled_path_lengths[i].value();
+                        if (root_index >= roots.size()) {
+                            throw std::invalid_argument("Merkle multiproof root index out of range");
+                        }
+                        // Every level of a path has arity - 1 distinct nodes, stored once each, so a longer
+                        // path than the nodes allow is malformed. Bound it before allocating the path.
+                        if (path_length > merkle_multiproof_max_path_length ||
+                            path_length > filled_nodes.size() / (arity - 1)) {
+                            throw std::invalid_argument("Merkle multiproof path is too long");
+                        }
+
+                        typename MerkleProof::path_type path(path_length);
+                        std::size_t node_index = leaf_index;
+                        for (std::size_t level = 0; level < path_length; level++, node_index /= arity) {
+                            const std::size_t group_begin = node_index - node_index % arity;
+                            for (std::size_t j = 0; j < arity - 1; j++) {
+                                const std::size_t position = merkle_proof_sibling_position<arity>(node_index, j);
+                                const node_key_type key(root_index, level, group_begin + position);
+                                auto it = node_indices.find(key);
+                                std::size_t node = 0;
+                                if (it == node_indices.end()) {
+                                    if (nodes.size() == filled_nodes.size()) {
+                                        throw std::invalid_argument("Merkle multiproof has too few nodes");
+                                    }
+                                    node = nodes.size();
+                                    nodes.push_back(make_merkle_node_value_fixed<MerkleProof, Endianness>(filled_nodes[node]));
+                                    node_indices.emplace(key, node);
+                                } else {
+                                    node = it->second;
+                                }
+                                path[level][j]._position = position;
+                                path[level][j]._hash = nodes[node];
+                            }
+                        }
+                        proofs.emplace_back(leaf_index, roots[root_index], path);
+                    }
+                    if (nodes.size() != filled_nodes.size()) {
+                        throw std::invalid_argument("Merkle multiproof has unused nodes");
+                    }
+                    return proofs;
+                }
+            }    // namespace types
+        }        // namespace marshalling
+    }            // namespace crypto3
+}    // namespace nil
+#endif    // CRYPTO3_MARSHALLING_MERKLE_MULTIPROOF_HPP
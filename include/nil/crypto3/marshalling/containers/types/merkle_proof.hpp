@@ -31,6 +31,9 @@
 #include <limits>
 #include <type_traits>
 #include <iterator>
+#include <algorithm>
+#include <array>
+#include <stdexcept>
 
 #include <nil/crypto3/algebra/type_traits.hpp>
 #include <nil/crypto3/marshalling/algebra/types/field_element.hpp>
@@ -98,6 +101,56 @@ namespace nil {
                                                                                    MerkleTree::arity>>::value>::type> {
                     using type = typename merkle_node_value<TTypeBase, typename MerkleTree::value_type>::type;
                 };
+            }    // namespace types
+
+            namespace detail {
+                // Accepts std::array and the digest types derived from it.
+                template<typename T, std::size_t N>
+                std::integral_constant<std::size_t, N> merkle_node_array_extent(const std::array<T, N> &);
+            }    // namespace detail
+
+            namespace types {
+                // Node value with its length fixed at compile time: byte digests are stored as exactly
+                // digest-size raw octets with no size prefix, field element nodes as in merkle_node_value.
+                template<typename TTypeBase, typename T, typename = void>
+                struct merkle_node_value_fixed;
+
+                template<typename TTypeBase, typename ValueType>
+                struct merkle_node_value_fixed<
+                    TTypeBase,
+                    ValueType,
+                    typename std::enable_if<std::is_same<
+                        std::uint8_t,
+                        typename std::iterator_traits<typename ValueType::iterator>::value_type>::value>::type> {
+                    static constexpr std::size_t size =
+                        decltype(detail::merkle_node_array_extent(std::declval<ValueType>()))::value;
+                    using type = nil::marshalling::types::array_list<
+                        TTypeBase,
+                        std::uint8_t,
+                        nil::marshalling::option::sequence_fixed_size<size>>;
+                };
+
+                template<typename TTypeBase, typename GroupElementType>
+                struct merkle_node_value_fixed<
+                    TTypeBase,
+                    GroupElementType,
+                    typename std::enable_if<nil::crypto3::algebra::is_field_element<
+                        GroupElementType
+                    >::value>::type
+                > {
+                    using type = field_element<TTypeBase, GroupElementType>;
+                };
+
+                template<typename TTypeBase, typename MerkleProof>
+                struct merkle_node_value_fixed<
+                    TTypeBase,
+                    MerkleProof,
+                    typename std::enable_if<
+                        std::is_same<MerkleProof,
+                                     nil::crypto3::containers::merkle_proof<typename MerkleProof::hash_type,
+                                                                            MerkleProof::arity>>::value>::type> {
+                    using type = typename merkle_node_value_fixed<TTypeBase, typename MerkleProof::value_type>::type;
+                };
 
                 template<typename TTypeBase, typename MerkleProof, typename = void>
                 struct merkle_proof_path_element {
@@ -149,6 +202,23 @@ namespace nil {
                                                         // path_type _path
                                                         typename merkle_proof_path<TTypeBase, MerkleProof>::type>>;
 
+                // Merkle proof without the per-element positions: they follow from the leaf index and the
+                // arity, so only the sibling nodes are stored, level by level, in fixed-size encoding.
+                template<typename TTypeBase, typename MerkleProof>
+                using merkle_proof_compact =
+                    nil::marshalling::types::bundle<TTypeBase,
+                                                    std::tuple<
+                                                        // std::size_t _li
+                                                        nil::marshalling::types::integral<TTypeBase, std::uint64_t>,
+                                                        // value_type _root
+                                                        typename merkle_node_value_fixed<TTypeBase, MerkleProof>::type,
+                                                        // sibling nodes, arity - 1 per path layer
+                                                        nil::marshalling::types::array_list<
+                                                            TTypeBase,
+                                                            typename merkle_node_value_fixed<TTypeBase, MerkleProof>::type,
+                                                            nil::marshalling::option::sequence_size_field_prefix<
+                                                                nil::marshalling::types::integral<TTypeBase, std::uint64_t>>>>>;
+
                 template<
                     typename ValueType,
                     typename Endianness,
@@ -244,6 +314,86 @@ namespace nil {
                     return make_merkle_node_value<typename MerkleProof::value_type, Endianness>(filled_node_value);
                 }
 
+                template<
+                    typename ValueType,
+                    typename Endianness,
+                    typename std::enable_if<
+                        std::is_same<std::uint8_t,
+                                     typename std::iterator_traits<typename ValueType::iterator>::value_type>::value,
+                        bool>::type = true>
+                typename merkle_node_value_fixed<nil::marshalling::field_type<Endianness>, ValueType>::type
+                    fill_merkle_node_value_fixed(const ValueType &node_value) {
+
+                    typename merkle_node_value_fixed<nil::marshalling::field_type<Endianness>, ValueType>::type
+                        filled_node_value;
+                    filled_node_value.value().assign(node_value.begin(), node_value.end());
+                    return filled_node_value;
+                }
+
+                template<
+                    typename GroupElementType,
+                    typename Endianness,
+                    typename std::enable_if<nil::crypto3::algebra::is_field_element<
+                        GroupElementType
+                    >::value, bool>::type = true>
+                typename merkle_node_value_fixed<nil::marshalling::field_type<Endianness>, GroupElementType>::type
+                    fill_merkle_node_value_fixed(const GroupElementType &node_value) {
+                    return fill_merkle_node_value<GroupElementType, Endianness>(node_value);
+                }
+
+                template<typename MerkleProof,
+                         typename Endianness,
+                         typename std::enable_if<
+                             std::is_same<MerkleProof,
+                                          nil::crypto3::containers::merkle_proof<typename MerkleProof::hash_type,
+                                                                                 MerkleProof::arity>>::value,
+                             bool>::type = true>
+                typename merkle_node_value_fixed<nil::marshalling::field_type<Endianness>, MerkleProof>::type
+                    fill_merkle_node_value_fixed(const typename MerkleProof::value_type &node_value) {
+                    return fill_merkle_node_value_fixed<typename MerkleProof::value_type, Endianness>(node_value);
+                }
+
+                template<
+                    typename ValueType,
+                    typename Endianness,
+                    typename std::enable_if<
+                        std::is_same<std::uint8_t,
+                                     typename std::iterator_traits<typename ValueType::iterator>::value_type>::value,
+                        bool>::type = true>
+                ValueType make_merkle_node_value_fixed(
+                    const typename merkle_node_value_fixed<nil::marshalling::field_type<Endianness>, ValueType>::type
+                        &filled_node_value) {
+                    ValueType node_value;
+                    BOOST_ASSERT(node_value.size() == filled_node_value.value().size());
+                    std::copy(filled_node_value.value().begin(), filled_node_value.value().end(), node_value.begin());
+                    return node_value;
+                }
+
+                template<
+                    typename GroupElementType,
+                    typename Endianness,
+                    typename std::enable_if<nil::crypto3::algebra::is_field_element<
+                        GroupElementType
+                    >::value, bool>::type = true>
+                GroupElementType make_merkle_node_value_fixed(
+                    const typename merkle_node_value_fixed<nil::marshalling::field_type<Endianness>, GroupElementType>::type
+                        &filled_node_value) {
+                    return filled_node_value.value();
+                }
+
+                template<typename MerkleProof,
+                         typename Endianness,
+                         typename std::enable_if<
+                             std::is_same<MerkleProof,
+                                          nil::crypto3::containers::merkle_proof<typename MerkleProof::hash_type,
+                                                                                 MerkleProof::arity>>::value,
+                             bool>::type = true>
+                typename MerkleProof::value_type make_merkle_node_value_fixed(
+                    const typename merkle_node_value_fixed<nil::marshalling::field_type<Endianness>, MerkleProof>::type
+                        &filled_node_value) {
+                    return make_merkle_node_value_fixed<typename MerkleProof::value_type, Endianness>(filled_node_value);
+                }
+
                 template<typename MerkleProof, typename Endianness>
                 typename merkle_proof_path_element<nil::marshalling::field_type<Endianness>, MerkleProof>::type
                     fill_merkle_proof_path_element(const typename MerkleProof::path_element_type &proof_path_element) {
@@ -319,6 +469,14 @@ namespace nil {
                     return proof_path;
                 }
 
+                // Position of the j-th sibling in the path layer above a node: siblings are stored in
+                // ascending order of their position in the group of Arity nodes, skipping the node itself.
+                template<std::size_t Arity>
+                std::size_t merkle_proof_sibling_position(std::size_t node_index, std::size_t j) {
+                    const std::size_t node_position = node_index % Arity;
+                    return j < node_position ? j : j + 1;
+                }
+
                 template<typename MerkleProof, typename Endianness>
                 merkle_proof<nil::marshalling::field_type<Endianness>, MerkleProof>
                     fill_merkle_proof(const MerkleProof &mp) {
@@ -347,6 +505,149 @@ namespace nil {
                     );
                     return mp;
                 }
+
+                template<typename MerkleProof, typename Endianness>
+                merkle_proof_compact<nil::marshalling::field_type<Endianness>, MerkleProof>
+                    fill_merkle_proof_compact(const MerkleProof &mp) {
+
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using uint64_t_marshalling_type = nil::marshalling::types::integral<TTypeBase, std::uint64_t>;
+                    constexpr std::size_t arity = MerkleProof::arity;
+
+                    merkle_proof_compact<TTypeBase, MerkleProof> filled;
+                    std::get<0>(filled.value()) = uint64_t_marshalling_type(mp.leaf_index());
+                    std::get<1>(filled.value()) = fill_merkle_node_value_fixed<MerkleProof, Endianness>(mp.root());
+                    auto &filled_nodes = std::get<2>(filled.value()).value();
+                    filled_nodes.reserve(mp.path().size() * (arity - 1));
+
+                    std::size_t node_index = mp.leaf_index();
+                    for (const auto &layer : mp.path()) {
+                        for (std::size_t j = 0; j < arity - 1; j++) {
+                            if (layer[j]._position != merkle_proof_sibling_position<arity>(node_index, j)) {
+                                throw std::invalid_argument(
+                                    "Merkle proof path element position does not match its leaf index");
+                            }
+                            filled_nodes.push_back(fill_merkle_node_value_fixed<MerkleProof, Endianness>(layer[j]._hash));
+                        }
+                        node_index /= arity;
+                    }
+                    return filled;
+                }
+
+                template<typename MerkleProof, typename Endianness>
+                MerkleProof make_merkle_proof_compact(
+                    const merkle_proof_compact<nil::marshalling::field_type<Endianness>, MerkleProof> &filled) {
+
+                    constexpr std::size_t arity = MerkleProof::arity;
+
+                    const std::size_t leaf_index = std::get<0>(filled.value()).value();
+                    const auto &filled_nodes = std::get<2>(filled.value()).value();
+                    if (filled_nodes.size() % (arity - 1) != 0) {
+                        throw std::invalid_argument("Merkle proof node count is not a multiple of arity - 1");
+                    }
+
+                    typename MerkleProof::path_type path(filled_nodes.size() / (arity - 1));
+                    std::size_t node_index = leaf_index;
+                    std::size_t cur = 0;
+                    for (auto &layer : path) {
+                        for (std::size_t j = 0; j < arity - 1; j++) {
+                            layer[j]._position = merkle_proof_sibling_position<arity>(node_index, j);
+                            layer[j]._hash = make_merkle_node_value_fixed<MerkleProof, Endianness>(filled_nodes[cur++]);
+                        }
+                        node_index /= arity;
+                    }
+                    return MerkleProof(
+                        leaf_index,
+                        make_merkle_node_value_fixed<MerkleProof, Endianness>(std::get<1>(filled.value())),
+                        path);
+                }
+            }    // namespace types
+
+            namespace detail {
+                // Reads one field and advances the remaining length past it.
+                template<typename Field, typename TIter>
+                nil::marshalling::status_type read_marshalling_field(Field &field, TIter &iter,
+                                                                     std::size_t &remaining_len) {
+                    nil::marshalling::status_type status = field.read(iter, remaining_len);
+                    if (status == nil::marshalling::status_type::success) {
+                        remaining_len -= field.length();
+                    }
+                    return status;
+                }
+
+                // Reads a sequence size prefix, rejecting sizes that cannot fit the remaining bytes.
+                template<typename TTypeBase, typename SizeType, typename TIter>
+                nil::marshalling::status_type read_marshalling_sequence_size(TIter &iter, std::size_t &remaining_len,
+                                                                             std::size_t &size) {
+                    nil::marshalling::types::integral<TTypeBase, SizeType> filled_size;
+                    nil::marshalling::status_type status = read_marshalling_field(filled_size, iter, remaining_len);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    if (filled_size.value() > remaining_len) {
+                        return nil::marshalling::status_type::invalid_msg_data;
+                    }
+                    size = filled_size.value();
+                    return status;
+                }
+            }    // namespace detail
+
+            namespace types {
+                // Reads a merkle_proof encoded value straight into proof, without building the bundle first.
+                template<typename MerkleProof, typename Endianness, typename TIter>
+                nil::marshalling::status_type read_merkle_proof(TIter &iter, std::size_t &remaining_len,
+                                                                MerkleProof &proof) {
+
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using node_value_marshalling_type = typename merkle_node_value<TTypeBase, MerkleProof>::type;
+
+                    nil::marshalling::types::integral<TTypeBase, std::uint64_t> filled_leaf_index;
+                    nil::marshalling::status_type status =
+                        detail::read_marshalling_field(filled_leaf_index, iter, remaining_len);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    node_value_marshalling_type filled_node;
+                    status = detail::read_marshalling_field(filled_node, iter, remaining_len);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    typename MerkleProof::value_type root = make_merkle_node_value<MerkleProof, Endianness>(filled_node);
+
+                    std::size_t layers_amount = 0;
+                    status = detail::read_marshalling_sequence_size<TTypeBase, std::uint64_t>(iter, remaining_len,
+                                                                                            layers_amount);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    typename MerkleProof::path_type path(layers_amount);
+                    nil::marshalling::types::integral<TTypeBase, std::uint64_t> filled_position;
+                    for (auto &layer : path) {
+                        std::size_t layer_size = 0;
+                        status = detail::read_marshalling_sequence_size<TTypeBase, std::uint64_t>(iter, remaining_len,
+                                                                                                layer_size);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        if (layer_size != layer.size()) {
+                            return nil::marshalling::status_type::invalid_msg_data;
+                        }
+                        for (auto &path_element : layer) {
+                            status = detail::read_marshalling_field(filled_position, iter, remaining_len);
+                            if (status != nil::marshalling::status_type::success) {
+                                return status;
+                            }
+                            status = detail::read_marshalling_field(filled_node, iter, remaining_len);
+                            if (status != nil::marshalling::status_type::success) {
+                                return status;
+                            }
+                            path_element._position = filled_position.value();
+                            path_element._hash = make_merkle_node_value<MerkleProof, Endianness>(filled_node);
+                        }
+                    }
+                    proof = MerkleProof(filled_leaf_index.value(), root, path);
+                    return status;
+                }
             }    // namespace types
         }        // namespace marshalling
     }            // namespace crypto3
@@ -0,0 +1,97 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Nil Foundation <info@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+
+#ifndef CRYPTO3_MARSHALLING_ZK_DETAIL_DOMAIN_SET_CACHE_HPP
+#define CRYPTO3_MARSHALLING_ZK_DETAIL_DOMAIN_SET_CACHE_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <nil/crypto3/math/algorithms/calculate_domain_set.hpp>
+#include <nil/crypto3/math/domains/evaluation_domain.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace marshalling {
+            namespace detail {
+                // Process-wide cache of the domain sets built by math::calculate_domain_set, one per field type,
+                // keyed by the maximal domain degree and the set size. Deserialized commitment params share
+                // the cached evaluation_domain objects, as copies of the same params already do.
+                template<typename FieldType>
+                class domain_set_cache {
+                public:
+                    using domain_set_type = std::vector<std::shared_ptr<math::evaluation_domain<FieldType>>>;
+
+                    static domain_set_cache &instance() {
+                        static domain_set_cache cache;
+                        return cache;
+                    }
+
+                    domain_set_type get(std::size_t max_domain_degree, std::size_t set_size) {
+                        const std::pair<std::size_t, std::size_t> key(max_domain_degree, set_size);
+                        {
+                            std::lock_guard<std::mutex> lock(_mutex);
+                            auto it = _domain_sets.find(key);
+                            if (it != _domain_sets.end()) {
+                                return it->second;
+                            }
+                        }
+                        // Built outside the lock; if two threads race, the first inserted set wins.
+                        domain_set_type domain_set = math::calculate_domain_set<FieldType>(max_domain_degree, set_size);
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        return _domain_sets.emplace(key, std::move(domain_set)).first->second;
+                    }
+
+                    std::size_t size() const {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        return _domain_sets.size();
+                    }
+
+                    void clear() {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _domain_sets.clear();
+                    }
+
+                private:
+                    domain_set_cache() = default;
+
+                    mutable std::mutex _mutex;
+                    std::map<std::pair<std::size_t, std::size_t>, domain_set_type> _domain_sets;
+                };
+
+                template<typename FieldType>
+                typename domain_set_cache<FieldType>::domain_set_type get_domain_set(std::size_t max_domain_degree,
+                                                                                     std::size_t set_size) {
+                    return domain_set_cache<FieldType>::instance().get(max_domain_degree, set_size);
+                }
+            }    // namespace detail
+        }        // namespace marshalling
+    }            // namespace crypto3
+}    // namespace nil
+
+#endif    // CRYPTO3_MARSHALLING_ZK_DETAIL_DOMAIN_SET_CACHE_HPP
@@ -0,0 +1,151 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Nil Foundation <info@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_MARSHALLING_ZK_DETAIL_FIELD_WRITER_HPP
+#define CRYPTO3_MARSHALLING_ZK_DETAIL_FIELD_WRITER_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include <nil/marshalling/status_type.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace marshalling {
+            namespace detail {
+                // Writers below share one interface: write(field) serializes a single marshalling field.
+                // They let the direct serializers emit the same bytes as the corresponding bundles
+                // without building the bundles first.
+
+                // Writes fields to an output iterator, tracking the remaining buffer length.
+                template<typename TIter>
+                class iterator_field_writer {
+                public:
+                    iterator_field_writer(TIter &iter, std::size_t len) : _iter(iter), _remaining_len(len) {
+                    }
+
+                    template<typename Field>
+                    nil::marshalling::status_type write(const Field &field) {
+                        nil::marshalling::status_type status = field.write(_iter, _remaining_len);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        _remaining_len -= field.length();
+                        return status;
+                    }
+
+                    std::size_t remaining_length() const {
+                        return _remaining_len;
+                    }
+
+                private:
+                    TIter &_iter;
+                    std::size_t _remaining_len;
+                };
+
+                // Appends fields to a byte vector, growing it as needed.
+                class vector_field_writer {
+                public:
+                    explicit vector_field_writer(std::vector<std::uint8_t> &out) : _out(out) {
+                    }
+
+                    template<typename Field>
+                    nil::marshalling::status_type write(const Field &field) {
+                        const std::size_t offset = _out.size();
+                        const std::size_t len = field.length();
+                        _out.resize(offset + len);
+                        auto iter = _out.begin() + offset;
+                        return field.write(iter, len);
+                    }
+
+                private:
+                    std::vector<std::uint8_t> &_out;
+                };
+
+                // Writes fields into a bounded byte buffer and hands full buffers to the derived sink.
+                template<typename Derived>
+                class buffered_field_writer {
+                public:
+                    explicit buffered_field_writer(std::size_t capacity) : _buffer(capacity), _used(0) {
+                    }
+
+                    template<typename Field>
+                    nil::marshalling::status_type write(const Field &field) {
+                        const std::size_t len = field.length();
+                        if (len > _buffer.size() - _used) {
+                            nil::marshalling::status_type status = flush();
+                            if (status != nil::marshalling::status_type::success) {
+                                return status;
+                            }
+                            if (len > _buffer.size()) {
+                                _buffer.resize(len);
+                            }
+                        }
+                        auto iter = _buffer.begin() + _used;
+                        nil::marshalling::status_type status = field.write(iter, _buffer.size() - _used);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        _used += len;
+                        return status;
+                    }
+
+                    nil::marshalling::status_type flush() {
+                        if (_used == 0) {
+                            return nil::marshalling::status_type::success;
+                        }
+                        nil::marshalling::status_type status =
+                            static_cast<Derived *>(this)->consume(_buffer.data(), _used);
+                        _used = 0;
+                        return status;
+                    }
+
+                private:
+                    std::vector<std::uint8_t> _buffer;
+                    std::size_t _used;
+                };
+
+                // Writes fields to a std::ostream through a bounded buffer.
+                class ostream_field_writer : public buffered_field_writer<ostream_field_writer> {
+                public:
+                    explicit ostream_field_writer(std::ostream &os, std::size_t capacity = 1 << 16) :
+                        buffered_field_writer<ostream_field_writer>(capacity), _os(os) {
+                    }
+
+                    nil::marshalling::status_type consume(const std::uint8_t *data, std::size_t len) {
+                        _os.write(reinterpret_cast<const char *>(data), len);
+                        return _os.good() ? nil::marshalling::status_type::success :
+                                            nil::marshalling::status_type::buffer_overflow;
+                    }
+
+                private:
+                    std::ostream &_os;
+                };
+            }    // namespace detail
+        }        // namespace marshalling
+    }            // namespace crypto3
+}    // namespace nil
+
+#endif    // CRYPTO3_MARSHALLING_ZK_DETAIL_FIELD_WRITER_HPP
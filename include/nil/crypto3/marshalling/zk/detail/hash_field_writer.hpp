@@ -0,0 +1,109 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Nil Foundation <info@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_MARSHALLING_ZK_DETAIL_HASH_FIELD_WRITER_HPP
+#define CRYPTO3_MARSHALLING_ZK_DETAIL_HASH_FIELD_WRITER_HPP
+
+#include <cstdint>
+#include <ostream>
+
+#include <nil/crypto3/algebra/type_traits.hpp>
+
+#include <nil/crypto3/hash/algorithm/hash.hpp>
+#include <nil/crypto3/hash/hash_state.hpp>
+
+#include <nil/marshalling/status_type.hpp>
+#include <nil/crypto3/marshalling/zk/detail/field_writer.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace marshalling {
+            namespace detail {
+                // Feeds the serialized bytes of the written fields into a Hash accumulator,
+                // so a digest of a serialization is computed without keeping the serialization.
+                // Only hashes consuming bytes are supported: algebraic hashes such as Poseidon
+                // absorb field elements, and their digest of a byte stream depends on how the
+                // bytes are packed into elements.
+                template<typename Hash>
+                class hash_field_writer : public buffered_field_writer<hash_field_writer<Hash>> {
+                    static_assert(!nil::crypto3::algebra::is_field_element<typename Hash::word_type>::value,
+                                  "hash_field_writer needs a byte-oriented hash");
+
+                public:
+                    using digest_type = typename Hash::digest_type;
+
+                    explicit hash_field_writer(std::size_t capacity = 1 << 16) :
+                        buffered_field_writer<hash_field_writer<Hash>>(capacity) {
+                    }
+
+                    nil::marshalling::status_type consume(const std::uint8_t *data, std::size_t len) {
+                        nil::crypto3::hash<Hash>(data, data + len, _acc);
+                        return nil::marshalling::status_type::success;
+                    }
+
+                    // Flushes the pending bytes and returns the digest of everything written so far.
+                    digest_type digest() {
+                        this->flush();
+                        return nil::crypto3::accumulators::extract::hash<Hash>(_acc);
+                    }
+
+                private:
+                    nil::crypto3::accumulator_set<Hash> _acc;
+                };
+
+                // Writes fields to a std::ostream and hashes the same bytes on the way.
+                template<typename Hash>
+                class hash_ostream_field_writer : public buffered_field_writer<hash_ostream_field_writer<Hash>> {
+                    static_assert(!nil::crypto3::algebra::is_field_element<typename Hash::word_type>::value,
+                                  "hash_ostream_field_writer needs a byte-oriented hash");
+
+                public:
+                    using digest_type = typename Hash::digest_type;
+
+                    explicit hash_ostream_field_writer(std::ostream &os, std::size_t capacity = 1 << 16) :
+                        buffered_field_writer<hash_ostream_field_writer<Hash>>(capacity), _os(os) {
+                    }
+
+                    nil::marshalling::status_type consume(const std::uint8_t *data, std::size_t len) {
+                        nil::crypto3::hash<Hash>(data, data + len, _acc);
+                        _os.write(reinterpret_cast<const char *>(data), len);
+                        return _os.good() ? nil::marshalling::status_type::success :
+                                            nil::marshalling::status_type::buffer_overflow;
+                    }
+
+                    // Digest of the bytes written so far. Call flush() first.
+                    digest_type digest() const {
+                        return nil::crypto3::accumulators::extract::hash<Hash>(_acc);
+                    }
+
+                private:
+                    std::ostream &_os;
+                    nil::crypto3::accumulator_set<Hash> _acc;
+                };
+            }    // namespace detail
+        }        // namespace marshalling
+    }            // namespace crypto3
+}    // namespace nil
+
+#endif    // CRYPTO3_MARSHALLING_ZK_DETAIL_HASH_FIELD_WRITER_HPP
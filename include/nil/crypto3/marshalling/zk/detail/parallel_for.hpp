@@ -0,0 +1,125 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Nil Foundation <info@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_MARSHALLING_ZK_DETAIL_PARALLEL_FOR_HPP
+#define CRYPTO3_MARSHALLING_ZK_DETAIL_PARALLEL_FOR_HPP
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace nil {
+    namespace crypto3 {
+        namespace marshalling {
+            namespace detail {
+                // Number of threads to use when the caller passes 0.
+                inline std::size_t default_threads_amount() {
+                    return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+                }
+
+                // Splits [begin, end) into at most threads_amount contiguous ranges of nearly equal size
+                // and calls func(range_begin, range_end) for each of them, one range per thread.
+                // The calling thread processes the first range, and every range whose thread could not be
+                // started. The first exception thrown by func is rethrown after all threads have joined.
+                template<typename Func>
+                void parallel_for(std::size_t begin, std::size_t end, std::size_t threads_amount, Func &&func) {
+                    if (begin >= end) {
+                        return;
+                    }
+                    if (threads_amount == 0) {
+                        threads_amount = default_threads_amount();
+                    }
+                    const std::size_t size = end - begin;
+                    threads_amount = std::min(threads_amount, size);
+                    if (threads_amount == 1) {
+                        func(begin, end);
+                        return;
+                    }
+
+                    std::vector<std::exception_ptr> exceptions(threads_amount);
+                    auto run = [&func, &exceptions](std::size_t index, std::size_t first, std::size_t last) {
+                        try {
+                            func(first, last);
+                        } catch (...) {
+                            exceptions[index] = std::current_exception();
+                        }
+                    };
+
+                    const std::size_t step = size / threads_amount;
+                    const std::size_t remainder = size % threads_amount;
+                    std::vector<std::thread> threads;
+                    threads.reserve(threads_amount - 1);
+                    std::size_t first = begin + step + (remainder > 0 ? 1 : 0);
+                    const std::size_t first_range_end = first;
+                    bool spawn = true;
+                    for (std::size_t i = 1; i < threads_amount; i++) {
+                        const std::size_t last = first + step + (i < remainder ? 1 : 0);
+                        if (spawn) {
+                            try {
+                                threads.emplace_back(run, i, first, last);
+                            } catch (...) {
+                                // Out of threads or memory: the threads already started must still be joined,
+                                // so this and the remaining ranges run on the calling thread instead.
+                                spawn = false;
+                            }
+                        }
+                        if (!spawn) {
+                            run(i, first, last);
+                        }
+                        first = last;
+                    }
+                    run(0, begin, first_range_end);
+                    for (auto &thread : threads) {
+                        thread.join();
+                    }
+                    for (const auto &exception : exceptions) {
+                        if (exception) {
+                            std::rethrow_exception(exception);
+                        }
+                    }
+                }
+
+                // Executor running on threads started by parallel_for for each call. An executor is any callable
+                // such that executor(tasks_amount, task) calls task(i) for every i in [0, tasks_amount), possibly
+                // concurrently, returns once all calls finished and propagates their first exception; callers
+                // decoding many objects pass one backed by their own thread pool instead.
+                struct thread_executor {
+                    std::size_t threads_amount;
+
+                    template<typename Task>
+                    void operator()(std::size_t tasks_amount, Task &&task) const {
+                        parallel_for(0, tasks_amount, threads_amount, [&task](std::size_t first, std::size_t last) {
+                            for (std::size_t i = first; i < last; i++) {
+                                task(i);
+                            }
+                        });
+                    }
+                };
+            } // namespace detail
+        } // namespace marshalling
+    } // namespace crypto3
+} // namespace nil
+
+#endif    // CRYPTO3_MARSHALLING_ZK_DETAIL_PARALLEL_FOR_HPP
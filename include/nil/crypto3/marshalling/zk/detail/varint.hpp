@@ -0,0 +1,86 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Nil Foundation <info@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_MARSHALLING_ZK_DETAIL_VARINT_HPP
+#define CRYPTO3_MARSHALLING_ZK_DETAIL_VARINT_HPP
+
+#include <cstdint>
+
+namespace nil {
+    namespace crypto3 {
+        namespace marshalling {
+            namespace detail {
+                // LEB128 unsigned varints: 7 bits per byte, least significant group first,
+                // the high bit of a byte is set when more bytes follow.
+
+                inline std::size_t varint_length(std::uint64_t value) {
+                    std::size_t length = 1;
+                    while (value >= 0x80) {
+                        value >>= 7;
+                        length++;
+                    }
+                    return length;
+                }
+
+                template<typename OutputIterator>
+                OutputIterator write_varint(std::uint64_t value, OutputIterator out) {
+                    while (value >= 0x80) {
+                        *out++ = static_cast<std::uint8_t>(value | 0x80);
+                        value >>= 7;
+                    }
+                    *out++ = static_cast<std::uint8_t>(value);
+                    return out;
+                }
+
+                // Returns false if the input ends in the middle of a varint or the value overflows 64 bits.
+                template<typename InputIterator>
+                bool read_varint(InputIterator &iter, const InputIterator &end, std::uint64_t &value) {
+                    value = 0;
+                    for (std::size_t shift = 0; shift < 64; shift += 7) {
+                        if (iter == end) {
+                            return false;
+                        }
+                        const std::uint8_t byte = static_cast<std::uint8_t>(*iter++);
+                        value |= std::uint64_t(byte & 0x7f) << shift;
+                        if ((byte & 0x80) == 0) {
+                            return shift < 63 || byte <= 1;
+                        }
+                    }
+                    return false;
+                }
+
+                // Maps signed values to unsigned ones so that small magnitudes get short varints.
+                inline std::uint64_t zigzag_encode(std::int64_t value) {
+                    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+                }
+
+                inline std::int64_t zigzag_decode(std::uint64_t value) {
+                    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+                }
+            } // namespace detail
+        } // namespace marshalling
+    } // namespace crypto3
+} // namespace nil
+
+#endif    // CRYPTO3_MARSHALLING_ZK_DETAIL_VARINT_HPP
@@ -25,6 +25,12 @@
 #ifndef CRYPTO3_MARSHALLING_FRI_COMMITMENT_PARAMS_HPP
 #define CRYPTO3_MARSHALLING_FRI_COMMITMENT_PARAMS_HPP
 
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
 #include <boost/assert.hpp>
 
 #include <nil/marshalling/types/bundle.hpp>
@@ -40,6 +46,8 @@
 #include <nil/crypto3/marshalling/algebra/types/curve_element.hpp>
 #include <nil/crypto3/math/algorithms/calculate_domain_set.hpp>
 
+#include <nil/crypto3/marshalling/zk/detail/domain_set_cache.hpp>
+
 namespace nil {
     namespace crypto3 {
         namespace marshalling {
@@ -194,7 +202,7 @@ namespace nil {
                     std::size_t max_degree = std::get<3>(filled_params.value()).value();
                     std::size_t expand_factor = std::get<6>(filled_params.value()).value();
                     std::size_t grinding_parameter = std::get<2>(filled_params.value()).value();
-                    auto D =  math::calculate_domain_set<typename CommitmentParamsType::field_type>(r + expand_factor + 1, r);
+                    auto D = nil::crypto3::marshalling::detail::get_domain_set<typename CommitmentParamsType::field_type>(r + expand_factor + 1, r);
                     // TODO: check generators correctness
 
                     return CommitmentParamsType(
@@ -208,6 +216,128 @@ namespace nil {
                     );
                 }
 
+                // Extended LPC commitment params: the plain encoding followed by the twiddle factors of the
+                // largest domain D[0], i.e. the first m/2 powers of its unity root. Twiddles of D[i] are every
+                // 2^i-th entry of the same table. All elements have the same length, so the table can be
+                // indexed in place in a serialized or memory-mapped buffer, see commitment_params_twiddle_view.
+                //
+                // The twiddles serve callers running their own FFTs over the params' domains. They do not
+                // speed up loading the params: math::evaluation_domain computes its own twiddles, so the
+                // params are decoded from the plain part with make_commitment_params as usual.
+                template<typename TTypeBase, typename CommitmentSchemeType>
+                using commitment_params_extended = nil::marshalling::types::bundle<
+                    TTypeBase,
+                    std::tuple<
+                        typename commitment_params<TTypeBase, CommitmentSchemeType>::type,
+                        field_element_vector_type<TTypeBase, typename CommitmentSchemeType::params_type::field_type::value_type>
+                    >
+                >;
+
+                template<typename Endianness, typename CommitmentSchemeType>
+                typename std::enable_if<nil::crypto3::zk::is_lpc<CommitmentSchemeType>,
+                                        commitment_params_extended<nil::marshalling::field_type<Endianness>, CommitmentSchemeType>>::type
+                fill_commitment_params_extended(const typename CommitmentSchemeType::params_type &fri_params) {
+                    using FieldType = typename CommitmentSchemeType::params_type::field_type;
+                    using result_type = commitment_params_extended<nil::marshalling::field_type<Endianness>, CommitmentSchemeType>;
+
+                    std::vector<typename FieldType::value_type> twiddles;
+                    if (!fri_params.D.empty()) {
+                        const auto &domain = fri_params.D[0];
+                        const typename FieldType::value_type omega = domain->get_unity_root();
+                        twiddles.reserve(domain->m / 2);
+                        typename FieldType::value_type power = FieldType::value_type::one();
+                        for (std::size_t i = 0; i < domain->m / 2; i++) {
+                            twiddles.push_back(power);
+                            power *= omega;
+                        }
+                    }
+
+                    return result_type(std::make_tuple(
+                        fill_commitment_params<Endianness, CommitmentSchemeType>(fri_params),
+                        fill_field_element_vector<typename FieldType::value_type, Endianness>(twiddles)
+                    ));
+                }
+
+                // Decodes the whole twiddle table. It is not checked against the domain; callers that do not
+                // trust the buffer compare the leading entries with D[0] of the decoded params.
+                template<typename Endianness, typename CommitmentSchemeType>
+                std::vector<typename CommitmentSchemeType::params_type::field_type::value_type>
+                make_commitment_params_twiddles(
+                    const commitment_params_extended<nil::marshalling::field_type<Endianness>, CommitmentSchemeType> &filled_params) {
+                    return make_field_element_vector<typename CommitmentSchemeType::params_type::field_type::value_type, Endianness>(
+                        std::get<1>(filled_params.value()));
+                }
+
+                // Read-only view over the twiddle table of serialized extended LPC commitment params.
+                // parse() only decodes the small plain params prefix; twiddles are read on demand from
+                // the buffer, which must outlive the view. The twiddles are not checked against the domain.
+                template<typename Endianness, typename CommitmentSchemeType>
+                class commitment_params_twiddle_view {
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using value_type = typename CommitmentSchemeType::params_type::field_type::value_type;
+                    using value_marshalling_type = field_element<TTypeBase, value_type>;
+                    using size_marshalling_type = nil::marshalling::types::integral<TTypeBase, std::size_t>;
+
+                public:
+                    nil::marshalling::status_type parse(const std::uint8_t *data, std::size_t len) {
+                        typename commitment_params<TTypeBase, CommitmentSchemeType>::type filled_params;
+                        const std::uint8_t *iter = data;
+                        nil::marshalling::status_type status = filled_params.read(iter, len);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        std::size_t remaining_len = len - filled_params.length();
+
+                        size_marshalling_type filled_size;
+                        status = filled_size.read(iter, remaining_len);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        remaining_len -= filled_size.length();
+
+                        const std::size_t element_len = value_marshalling_type(value_type::zero()).length();
+                        if (filled_size.value() > remaining_len / element_len) {
+                            return nil::marshalling::status_type::not_enough_data;
+                        }
+                        _twiddles = iter;
+                        _size = filled_size.value();
+                        _element_len = element_len;
+                        return nil::marshalling::status_type::success;
+                    }
+
+                    // Number of twiddles of D[0].
+                    std::size_t size() const {
+                        return _size;
+                    }
+
+                    // omega^i for the unity root omega of D[0]. Throws std::out_of_range unless i < size(), and
+                    // std::invalid_argument if the stored element cannot be decoded.
+                    value_type twiddle(std::size_t i) const {
+                        if (i >= _size) {
+                            throw std::out_of_range("Twiddle index is out of range");
+                        }
+                        value_marshalling_type filled_value;
+                        const std::uint8_t *iter = _twiddles + i * _element_len;
+                        if (filled_value.read(iter, _element_len) != nil::marshalling::status_type::success) {
+                            throw std::invalid_argument("Malformed twiddle in commitment params");
+                        }
+                        return filled_value.value();
+                    }
+
+                    // i-th twiddle of D[domain_index]. Throws std::out_of_range unless i < size() >> domain_index.
+                    value_type domain_twiddle(std::size_t domain_index, std::size_t i) const {
+                        if (domain_index >= std::numeric_limits<std::size_t>::digits || i >= (_size >> domain_index)) {
+                            throw std::out_of_range("Twiddle index is out of range");
+                        }
+                        return twiddle(i << domain_index);
+                    }
+
+                private:
+                    const std::uint8_t *_twiddles = nullptr;
+                    std::size_t _size = 0;
+                    std::size_t _element_len = 0;
+                };
+
                 // Define commitment_params marshalling type for KZG.
                 template<typename Endianness, typename CommitmentSchemeType>
                 struct commitment_params<nil::marshalling::field_type<Endianness>, CommitmentSchemeType, std::enable_if_t<nil::crypto3::zk::is_kzg<CommitmentSchemeType>>> {
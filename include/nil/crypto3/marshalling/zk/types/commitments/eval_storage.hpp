@@ -27,7 +27,11 @@
 
 #include <ratio>
 #include <limits>
+#include <iterator>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <boost/assert.hpp>
 
@@ -40,6 +44,7 @@
 #include <nil/crypto3/marshalling/algebra/types/field_element.hpp>
 #include <nil/crypto3/marshalling/containers/types/merkle_proof.hpp>
 #include <nil/crypto3/marshalling/zk/types/commitments/fri.hpp>
+#include <nil/crypto3/marshalling/zk/detail/varint.hpp>
 
 namespace nil {
     namespace crypto3 {
@@ -145,13 +150,13 @@ namespace nil {
                     typename nil::crypto3::marshalling::types::batch_info_type batch_info;
                     std::vector<std::uint8_t> eval_points_num;
 
-                    auto filled_batch_info = std::get<1>(filled_storage.value()).value();
+                    const auto &filled_batch_info = std::get<1>(filled_storage.value()).value();
                     for( std::size_t i = 0; i < filled_batch_info.size(); i+=2 ){
                         batch_info[filled_batch_info[i].value()] = filled_batch_info[i+1].value();
                         z.set_batch_size(filled_batch_info[i].value(), filled_batch_info[i+1].value());
                     }
 
-                    auto filled_eval_points_num = std::get<2>(filled_storage.value()).value();
+                    const auto &filled_eval_points_num = std::get<2>(filled_storage.value()).value();
                     std::size_t cur = 0;
                     for( const auto &it:batch_info){
                         for( std::size_t i = 0; i < it.second; i++ ){
@@ -160,7 +165,7 @@ namespace nil {
                         }
                     }
 
-                    auto filled_z = std::get<0>(filled_storage.value()).value();
+                    const auto &filled_z = std::get<0>(filled_storage.value()).value();
                     cur = 0;
                     for( const auto &it:batch_info){
                         for( std::size_t i = 0; i < it.second; i++ ){
@@ -173,6 +178,138 @@ namespace nil {
 
                     return z;
                 }
+
+                // Same content as eval_storage, with the batch metadata as LEB128 varints instead of uint8_t:
+                // batches amount, then (batch id, batch size) for every batch, then the points number of
+                // every polynomial, batch by batch.
+                template < typename TTypeBase, typename EvalStorage >
+                    using eval_storage_varint = nil::marshalling::types::bundle<
+                    TTypeBase,
+                    std::tuple<
+                        // All z-s are placed into plain array
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            field_element<TTypeBase, typename EvalStorage::field_type::value_type>,
+                            nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >,
+
+                        // varint metadata
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            nil::marshalling::types::integral<TTypeBase, uint8_t>,
+                            nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >
+                    >
+                >;
+
+                template<typename Endianness, typename EvalStorage>
+                eval_storage_varint<nil::marshalling::field_type<Endianness>, EvalStorage>
+                fill_eval_storage_varint( const EvalStorage &z ){
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using octet_marshalling_type = nil::marshalling::types::integral<TTypeBase, uint8_t>;
+
+                    auto batches = z.get_batches();
+                    std::vector<std::uint8_t> metadata;
+                    std::size_t z_amount = 0;
+                    detail::write_varint(batches.size(), std::back_inserter(metadata));
+                    for( std::size_t i = 0; i < batches.size(); i++ ){
+                        detail::write_varint(batches[i], std::back_inserter(metadata));
+                        detail::write_varint(z.get_batch_size(batches[i]), std::back_inserter(metadata));
+                    }
+                    for( std::size_t i = 0; i < batches.size(); i++ ){
+                        for( std::size_t j = 0; j < z.get_batch_size(batches[i]); j++ ){
+                            detail::write_varint(z.get_poly_points_number(batches[i], j), std::back_inserter(metadata));
+                            z_amount += z.get_poly_points_number(batches[i], j);
+                        }
+                    }
+
+                    eval_storage_varint<TTypeBase, EvalStorage> filled_storage;
+                    auto &filled_z = std::get<0>(filled_storage.value()).value();
+                    filled_z.reserve(z_amount);
+                    for( std::size_t i = 0; i < batches.size(); i++ ){
+                        for(std::size_t j = 0; j < z.get_batch_size(batches[i]); j++ ){
+                            for(std::size_t k = 0; k < z.get_poly_points_number(batches[i], j); k++ ){
+                                filled_z.emplace_back(z.get(batches[i], j, k));
+                            }
+                        }
+                    }
+                    auto &filled_metadata = std::get<1>(filled_storage.value()).value();
+                    filled_metadata.reserve(metadata.size());
+                    for( const std::uint8_t byte : metadata ){
+                        filled_metadata.push_back(octet_marshalling_type(byte));
+                    }
+                    return filled_storage;
+                }
+
+                // Decodes the metadata first, so every polynomial's offset into the z array is known, then
+                // fills the storage reading the filled values in place. Throws std::invalid_argument on
+                // malformed metadata or a z array of the wrong size.
+                template<typename Endianness, typename EvalStorage>
+                EvalStorage make_eval_storage_varint(
+                    const eval_storage_varint<nil::marshalling::field_type<Endianness>, EvalStorage> &filled_storage
+                ){
+                    const auto &filled_z = std::get<0>(filled_storage.value()).value();
+                    const auto &filled_metadata = std::get<1>(filled_storage.value()).value();
+
+                    std::vector<std::uint8_t> metadata;
+                    metadata.reserve(filled_metadata.size());
+                    for( const auto &byte : filled_metadata ){
+                        metadata.push_back(byte.value());
+                    }
+                    auto iter = metadata.cbegin();
+                    auto read_metadata = [&iter, &metadata]() {
+                        std::uint64_t value = 0;
+                        if (!detail::read_varint(iter, metadata.cend(), value)) {
+                            throw std::invalid_argument("Invalid varint in eval storage metadata");
+                        }
+                        return value;
+                    };
+
+                    // Every entry takes at least one byte, which bounds the sizes before allocating.
+                    const std::uint64_t batches_amount = read_metadata();
+                    if (batches_amount > metadata.size()) {
+                        throw std::invalid_argument("Eval storage metadata is too short");
+                    }
+                    std::vector<std::pair<std::size_t, std::size_t>> batches(batches_amount);
+                    std::size_t polys_amount = 0;
+                    for( auto &batch : batches ){
+                        batch.first = read_metadata();
+                        batch.second = read_metadata();
+                        if (batch.second > metadata.size() - polys_amount) {
+                            throw std::invalid_argument("Eval storage metadata is too short");
+                        }
+                        polys_amount += batch.second;
+                    }
+
+                    // The offsets stay within filled_z, so they cannot wrap around.
+                    std::vector<std::size_t> offsets(polys_amount + 1, 0);
+                    for( std::size_t i = 0; i < polys_amount; i++ ){
+                        const std::uint64_t points_number = read_metadata();
+                        if (points_number > filled_z.size() - offsets[i]) {
+                            throw std::invalid_argument("Eval storage z values amount mismatch");
+                        }
+                        offsets[i + 1] = offsets[i] + points_number;
+                    }
+                    if (iter != metadata.cend()) {
+                        throw std::invalid_argument("Eval storage metadata has trailing bytes");
+                    }
+                    if (offsets.back() != filled_z.size()) {
+                        throw std::invalid_argument("Eval storage z values amount mismatch");
+                    }
+
+                    EvalStorage z;
+                    std::size_t poly = 0;
+                    for( const auto &batch : batches ){
+                        z.set_batch_size(batch.first, batch.second);
+                        for( std::size_t i = 0; i < batch.second; i++, poly++ ){
+                            z.set_poly_points_number(batch.first, i, offsets[poly + 1] - offsets[poly]);
+                            for( std::size_t j = offsets[poly]; j < offsets[poly + 1]; j++ ){
+                                z.set(batch.first, i, j - offsets[poly], filled_z[j].value());
+                            }
+                        }
+                    }
+                    return z;
+                }
             }    // namespace types
         }        // namespace marshalling
     }            // namespace crypto3
@@ -29,7 +29,12 @@
 
 #include <limits>
 #include <map>
+#include <optional>
 #include <ratio>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
 #include <type_traits>
 
 #include <boost/assert.hpp>
@@ -42,6 +47,8 @@
 
 #include <nil/crypto3/marshalling/algebra/types/field_element.hpp>
 #include <nil/crypto3/marshalling/containers/types/merkle_proof.hpp>
+#include <nil/crypto3/marshalling/containers/types/merkle_multiproof.hpp>
+#include <nil/crypto3/marshalling/zk/detail/parallel_for.hpp>
 
 namespace nil {
     namespace crypto3 {
@@ -193,22 +200,46 @@ namespace nil {
 
                 using batch_info_type = std::map<std::size_t, std::size_t>;// batch_id->batch_size
 
-                template <typename Endianness, typename FRI>
-                typename fri_proof<nil::marshalling::field_type<Endianness>, FRI>::type
-                fill_fri_proof(const typename FRI::proof_type &proof, const batch_info_type &batch_info, const typename FRI::params_type& params) {
-                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                template<typename TTypeBase, typename FRI>
+                using fri_roots_type = nil::marshalling::types::array_list<
+                    TTypeBase, typename types::merkle_node_value<TTypeBase, typename FRI::merkle_proof_type>::type,
+                    nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                >;
 
-                    // merkle roots
-                    nil::marshalling::types::array_list<
-                        TTypeBase, typename types::merkle_node_value<TTypeBase, typename FRI::merkle_proof_type>::type,
-                        nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
-                    > filled_fri_roots;
+                template<typename TTypeBase>
+                using fri_step_list_type = nil::marshalling::types::array_list<
+                    TTypeBase,
+                    nil::marshalling::types::integral<TTypeBase, std::uint8_t>,
+                    nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                >;
+
+                template <typename Endianness, typename FRI>
+                fri_roots_type<nil::marshalling::field_type<Endianness>, FRI>
+                fill_fri_roots(const typename FRI::proof_type &proof) {
+                    fri_roots_type<nil::marshalling::field_type<Endianness>, FRI> filled_fri_roots;
                     for( size_t i = 0; i < proof.fri_roots.size(); i++){
                         filled_fri_roots.value().push_back(fill_merkle_node_value<typename FRI::commitment_type, Endianness>(proof.fri_roots[i]));
                     }
+                    return filled_fri_roots;
+                }
+
+                template <typename Endianness, typename StepList>
+                fri_step_list_type<nil::marshalling::field_type<Endianness>>
+                fill_fri_step_list(const StepList &step_list) {
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+
+                    fri_step_list_type<TTypeBase> filled_step_list;
+                    for (const auto& step : step_list) {
+                        filled_step_list.value().push_back(nil::marshalling::types::integral<TTypeBase, std::uint8_t>(step));
+                    }
+                    return filled_step_list;
+                }
 
+                // Initial polynomials' values, lambda * polynomials_num * coset_size * m
+                template <typename Endianness, typename FRI>
+                field_element_vector_type<nil::marshalling::field_type<Endianness>, typename FRI::field_type::value_type>
+                fill_fri_initial_values(const typename FRI::proof_type &proof, const batch_info_type &batch_info, const typename FRI::params_type& params) {
                     std::size_t lambda = proof.query_proofs.size();
-                    // initial_polynomials values
                     std::vector<typename FRI::field_type::value_type> initial_val;
                     for( std::size_t i = 0; i < lambda; i++ ){
                         auto &query_proof = proof.query_proofs[i];
@@ -225,13 +256,14 @@ namespace nil {
                             }
                         }
                     }
-                    nil::marshalling::types::array_list<
-                        TTypeBase,
-                        field_element<TTypeBase, typename FRI::field_type::value_type>,
-                        nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
-                    > filled_initial_val = fill_field_element_vector<typename FRI::field_type::value_type, Endianness>(initial_val);
+                    return fill_field_element_vector<typename FRI::field_type::value_type, Endianness>(initial_val);
+                }
 
-                    // fill round values
+                // Round polynomials' values, lambda * \sum_rounds{m^{r_i}}
+                template <typename Endianness, typename FRI>
+                field_element_vector_type<nil::marshalling::field_type<Endianness>, typename FRI::field_type::value_type>
+                fill_fri_round_values(const typename FRI::proof_type &proof) {
+                    std::size_t lambda = proof.query_proofs.size();
                     std::vector<typename FRI::field_type::value_type> round_val;
                     for( std::size_t i = 0; i < lambda; i++ ){
                         auto &query_proof = proof.query_proofs[i];
@@ -243,21 +275,15 @@ namespace nil {
                             }
                         }
                     }
-                    nil::marshalling::types::array_list<
-                        TTypeBase,
-                        field_element<TTypeBase, typename FRI::field_type::value_type>,
-                        nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
-                    > filled_round_val = fill_field_element_vector<typename FRI::field_type::value_type, Endianness>(round_val);
+                    return fill_field_element_vector<typename FRI::field_type::value_type, Endianness>(round_val);
+                }
 
-                    // step_list
-                    nil::marshalling::types::array_list<
-                        TTypeBase,
-                        nil::marshalling::types::integral<TTypeBase, std::uint8_t>,
-                        nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
-                    > filled_step_list;
-                    for (const auto& step : params.step_list) {
-                        filled_step_list.value().push_back(nil::marshalling::types::integral<TTypeBase, std::uint8_t>(step));
-                    }
+                template <typename Endianness, typename FRI>
+                typename fri_proof<nil::marshalling::field_type<Endianness>, FRI>::type
+                fill_fri_proof(const typename FRI::proof_type &proof, const batch_info_type &batch_info, const typename FRI::params_type& params) {
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+
+                    std::size_t lambda = proof.query_proofs.size();
 
                     // initial merkle proofs
                     nil::marshalling::types::array_list<
@@ -297,7 +323,10 @@ namespace nil {
                     // proof_of_work
                     return typename fri_proof<nil::marshalling::field_type<Endianness>, FRI>::type(
                         std::tuple(
-                            filled_fri_roots, filled_step_list, filled_initial_val, filled_round_val,
+                            fill_fri_roots<Endianness, FRI>(proof),
+                            fill_fri_step_list<Endianness>(params.step_list),
+                            fill_fri_initial_values<Endianness, FRI>(proof, batch_info, params),
+                            fill_fri_round_values<Endianness, FRI>(proof),
                             filled_initial_merkle_proofs, filled_round_merkle_proofs, filled_final_polynomial,
                             nil::marshalling::types::integral<TTypeBase, typename FRI::grinding_type::output_type>(proof.proof_of_work)
                         )
@@ -305,28 +334,83 @@ namespace nil {
                 }
 
                 template <typename Endianness, typename FRI>
-                typename FRI::proof_type
-                make_fri_proof(
-                    const typename fri_proof<nil::marshalling::field_type<Endianness>, FRI>::type &filled_proof, const batch_info_type &batch_info
+                void make_fri_roots(
+                    const fri_roots_type<nil::marshalling::field_type<Endianness>, FRI> &filled_fri_roots,
+                    typename FRI::proof_type &proof
                 ){
-                    typename FRI::proof_type proof;
-                    // merkle roots
-                    for( std::size_t i = 0; i < std::get<0>(filled_proof.value()).value().size(); i++){
+                    for( std::size_t i = 0; i < filled_fri_roots.value().size(); i++){
                         proof.fri_roots.push_back(
-                            make_merkle_node_value<typename FRI::commitment_type, Endianness>(std::get<0>(filled_proof.value()).value()[i])
+                            make_merkle_node_value<typename FRI::commitment_type, Endianness>(filled_fri_roots.value()[i])
                         );
                     }
-                    // step_list
+                }
+
+                template <typename Endianness>
+                std::vector<std::uint8_t> make_fri_step_list(
+                    const fri_step_list_type<nil::marshalling::field_type<Endianness>> &filled_step_list
+                ){
                     std::vector<std::uint8_t> step_list;
-                    for( std::size_t i = 0; i < std::get<1>(filled_proof.value()).value().size(); i++){
-                        auto c = std::get<1>(filled_proof.value()).value()[i].value();
-                        step_list.push_back(c);
+                    for( std::size_t i = 0; i < filled_step_list.value().size(); i++){
+                        step_list.push_back(filled_step_list.value()[i].value());
                     }
+                    return step_list;
+                }
 
-                    std::size_t lambda = std::get<5>(filled_proof.value()).value().size() / step_list.size();
-                    proof.query_proofs.resize(lambda);
-                    // initial_polynomials values
-                    std::size_t coset_size = 1 << (step_list[0] - 1);
+                // A decoded step_list is usable if it is not empty and every step is a shift of a 32-bit coset size.
+                inline bool fri_step_list_is_valid(const std::vector<std::uint8_t> &step_list) {
+                    for( const auto &step : step_list ){
+                        if (step == 0 || step >= std::numeric_limits<std::uint32_t>::digits) {
+                            return false;
+                        }
+                    }
+                    return !step_list.empty();
+                }
+
+                // Field elements one query contributes to the initial values section. Throws std::invalid_argument
+                // if the step_list is not valid.
+                template <typename FRI>
+                std::size_t fri_query_initial_values_amount(const batch_info_type &batch_info, const std::vector<std::uint8_t> &step_list) {
+                    if (!fri_step_list_is_valid(step_list)) {
+                        throw std::invalid_argument("FRI proof step_list is invalid");
+                    }
+                    std::size_t coset_size = std::size_t(1) << (step_list[0] - 1);
+                    std::size_t amount = 0;
+                    for( const auto &it:batch_info){
+                        amount += it.second * coset_size * FRI::m;
+                    }
+                    return amount;
+                }
+
+                // Field elements one query contributes to the round values section. Throws std::invalid_argument
+                // if the step_list is not valid.
+                template <typename FRI>
+                std::size_t fri_query_round_values_amount(const std::vector<std::uint8_t> &step_list) {
+                    if (!fri_step_list_is_valid(step_list)) {
+                        throw std::invalid_argument("FRI proof step_list is invalid");
+                    }
+                    std::size_t amount = 0;
+                    for( std::size_t r = 0; r < step_list.size(); r++ ){
+                        amount += (r == step_list.size() - 1 ? 1 : (std::size_t(1) << (step_list[r+1] - 1))) * FRI::m;
+                    }
+                    return amount;
+                }
+
+                // Fills initial_proof values of proof.query_proofs, which must already hold lambda queries.
+                // Throws std::invalid_argument if the section does not hold exactly the expected values.
+                template <typename Endianness, typename FRI>
+                void make_fri_initial_values(
+                    const field_element_vector_type<nil::marshalling::field_type<Endianness>, typename FRI::field_type::value_type> &filled_initial_val,
+                    const batch_info_type &batch_info,
+                    const std::vector<std::uint8_t> &step_list,
+                    typename FRI::proof_type &proof
+                ){
+                    std::size_t lambda = proof.query_proofs.size();
+                    std::size_t query_size = fri_query_initial_values_amount<FRI>(batch_info, step_list);
+                    if ((query_size != 0 && filled_initial_val.value().size() / query_size != lambda) ||
+                        filled_initial_val.value().size() != lambda * query_size) {
+                        throw std::invalid_argument("FRI proof initial values size mismatch");
+                    }
+                    std::size_t coset_size = std::size_t(1) << (step_list[0] - 1);
                     std::size_t cur = 0;
                     for( std::size_t i = 0; i < lambda; i++ ){
                         for( const auto &it:batch_info){
@@ -336,35 +420,66 @@ namespace nil {
                                 proof.query_proofs[i].initial_proof[it.first].values[j].resize(coset_size);
                                 for( std::size_t k = 0; k < coset_size; k++){
                                     for( std::size_t l = 0; l < FRI::m; l++, cur++ ){
-                                        BOOST_ASSERT(cur < std::get<2>(filled_proof.value()).value().size());
-                                        proof.query_proofs[i].initial_proof[it.first].values[j][k][l] = std::get<2>(filled_proof.value()).value()[cur].value();
+                                        proof.query_proofs[i].initial_proof[it.first].values[j][k][l] = filled_initial_val.value()[cur].value();
                                     }
                                 }
                             }
                         }
                     }
+                }
 
-                    // round polynomials values
-                    cur = 0;
+                // Fills round_proofs values of proof.query_proofs, which must already hold lambda queries.
+                // Throws std::invalid_argument if the section does not hold exactly the expected values.
+                template <typename Endianness, typename FRI>
+                void make_fri_round_values(
+                    const field_element_vector_type<nil::marshalling::field_type<Endianness>, typename FRI::field_type::value_type> &filled_round_val,
+                    const std::vector<std::uint8_t> &step_list,
+                    typename FRI::proof_type &proof
+                ){
+                    std::size_t lambda = proof.query_proofs.size();
+                    std::size_t query_size = fri_query_round_values_amount<FRI>(step_list);
+                    if (filled_round_val.value().size() / query_size != lambda ||
+                        filled_round_val.value().size() != lambda * query_size) {
+                        throw std::invalid_argument("FRI proof round values size mismatch");
+                    }
+                    std::size_t cur = 0;
                     for(std::size_t i = 0; i < lambda; i++ ){
                         proof.query_proofs[i].round_proofs.resize(step_list.size());
                         for(std::size_t r = 0; r < step_list.size(); r++ ){
-                            coset_size = r == step_list.size() - 1? 1: (1 << (step_list[r+1]-1));
+                            std::size_t coset_size = r == step_list.size() - 1? 1: (std::size_t(1) << (step_list[r+1]-1));
                             proof.query_proofs[i].round_proofs[r].y.resize(coset_size);
                             for( std::size_t j = 0; j < coset_size; j++){
                                 for( std::size_t k = 0; k < FRI::m; k++, cur++){
-                                    BOOST_ASSERT(cur < std::get<3>(filled_proof.value()).value().size());
-                                    proof.query_proofs[i].round_proofs[r].y[j][k] = std::get<3>(filled_proof.value()).value()[cur].value();
+                                    proof.query_proofs[i].round_proofs[r].y[j][k] = filled_round_val.value()[cur].value();
                                 }
                             }
                         }
                     }
+                }
+
+                // Fills initial_proof and round_proofs Merkle proofs of proof.query_proofs, which must already hold
+                // lambda queries with round_proofs sized to the step_list. Throws std::invalid_argument if the
+                // sections do not hold exactly lambda * batches_num and lambda * |step_list| proofs.
+                template <typename Endianness, typename FRI>
+                void make_fri_query_merkle_proofs(
+                    const merkle_proof_vector_type<nil::marshalling::field_type<Endianness>, FRI> &filled_initial_merkle_proofs,
+                    const merkle_proof_vector_type<nil::marshalling::field_type<Endianness>, FRI> &filled_round_merkle_proofs,
+                    const batch_info_type &batch_info,
+                    const std::vector<std::uint8_t> &step_list,
+                    typename FRI::proof_type &proof
+                ){
+                    std::size_t lambda = proof.query_proofs.size();
+                    if (filled_initial_merkle_proofs.value().size() != lambda * batch_info.size() ||
+                        filled_round_merkle_proofs.value().size() != lambda * step_list.size()) {
+                        throw std::invalid_argument("FRI proof merkle proofs size mismatch");
+                    }
+
                     // initial merkle proofs
-                    cur = 0;
+                    std::size_t cur = 0;
                     for( std::size_t i = 0; i < lambda; i++ ){
                         for( const auto &it:batch_info){
                             proof.query_proofs[i].initial_proof[it.first].p = make_merkle_proof<typename FRI::merkle_proof_type, Endianness>(
-                                std::get<4>(filled_proof.value()).value()[cur++]
+                                filled_initial_merkle_proofs.value()[cur++]
                             );
                         }
                     }
@@ -374,10 +489,36 @@ namespace nil {
                     for( std::size_t i = 0; i < lambda; i++ ){
                         for( std::size_t r = 0; r < step_list.size(); r++, cur++ ){
                             proof.query_proofs[i].round_proofs[r].p = make_merkle_proof<typename FRI::merkle_proof_type, Endianness>(
-                                std::get<5>(filled_proof.value()).value()[cur]
+                                filled_round_merkle_proofs.value()[cur]
                             );
                         }
                     }
+                }
+
+                template <typename Endianness, typename FRI>
+                typename FRI::proof_type
+                make_fri_proof(
+                    const typename fri_proof<nil::marshalling::field_type<Endianness>, FRI>::type &filled_proof, const batch_info_type &batch_info
+                ){
+                    typename FRI::proof_type proof;
+                    // merkle roots
+                    make_fri_roots<Endianness, FRI>(std::get<0>(filled_proof.value()), proof);
+                    // step_list
+                    std::vector<std::uint8_t> step_list = make_fri_step_list<Endianness>(std::get<1>(filled_proof.value()));
+                    if (!fri_step_list_is_valid(step_list)) {
+                        throw std::invalid_argument("FRI proof step_list is invalid");
+                    }
+
+                    std::size_t lambda = std::get<5>(filled_proof.value()).value().size() / step_list.size();
+                    proof.query_proofs.resize(lambda);
+                    // initial_polynomials values
+                    make_fri_initial_values<Endianness, FRI>(std::get<2>(filled_proof.value()), batch_info, step_list, proof);
+                    // round polynomials values
+                    make_fri_round_values<Endianness, FRI>(std::get<3>(filled_proof.value()), step_list, proof);
+
+                    // initial and round merkle proofs
+                    make_fri_query_merkle_proofs<Endianness, FRI>(
+                        std::get<4>(filled_proof.value()), std::get<5>(filled_proof.value()), batch_info, step_list, proof);
 
                     // final_polynomial
                     proof.final_polynomial = make_fri_math_polynomial<Endianness, typename FRI::polynomial_type>(
@@ -387,6 +528,593 @@ namespace nil {
                     proof.proof_of_work = std::get<7>(filled_proof.value()).value();
                     return proof;
                 }
+
+                // Reads the leading merkle roots and step_list sections of the fri_proof encoding.
+                template <typename Endianness, typename FRI, typename TIter, typename RootsContainer>
+                nil::marshalling::status_type read_fri_roots_and_step_list(
+                    TIter &iter, std::size_t &remaining_len, RootsContainer &fri_roots, std::vector<std::uint8_t> &step_list
+                ){
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using node_value_marshalling_type = typename types::merkle_node_value<TTypeBase, typename FRI::merkle_proof_type>::type;
+
+                    std::size_t size = 0;
+                    nil::marshalling::status_type status = detail::read_marshalling_sequence_size<TTypeBase, std::size_t>(iter, remaining_len, size);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    fri_roots.clear();
+                    fri_roots.reserve(size);
+                    node_value_marshalling_type filled_root;
+                    for( std::size_t i = 0; i < size; i++ ){
+                        status = detail::read_marshalling_field(filled_root, iter, remaining_len);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        fri_roots.push_back(make_merkle_node_value<typename FRI::commitment_type, Endianness>(filled_root));
+                    }
+
+                    status = detail::read_marshalling_sequence_size<TTypeBase, std::size_t>(iter, remaining_len, size);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    if (size == 0 || size > remaining_len) {
+                        return nil::marshalling::status_type::invalid_msg_data;
+                    }
+                    step_list.resize(size);
+                    nil::marshalling::types::integral<TTypeBase, std::uint8_t> filled_step;
+                    for( auto &step : step_list ){
+                        status = detail::read_marshalling_field(filled_step, iter, remaining_len);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        step = filled_step.value();
+                    }
+                    if (!fri_step_list_is_valid(step_list)) {
+                        return nil::marshalling::status_type::invalid_msg_data;
+                    }
+                    return status;
+                }
+
+                // Reads one query's slice of the initial values section into query.initial_proof values.
+                template <typename Endianness, typename FRI, typename TIter>
+                nil::marshalling::status_type read_fri_query_initial_values(
+                    TIter &iter, std::size_t &remaining_len, const batch_info_type &batch_info,
+                    const std::vector<std::uint8_t> &step_list, typename FRI::query_proof_type &query
+                ){
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+
+                    field_element<TTypeBase, typename FRI::field_type::value_type> filled_value;
+                    std::size_t coset_size = std::size_t(1) << (step_list[0] - 1);
+                    for( const auto &it:batch_info){
+                        auto &initial_proof = query.initial_proof[it.first];
+                        initial_proof.values.resize(it.second);
+                        for( auto &poly_values : initial_proof.values ){
+                            poly_values.resize(coset_size);
+                            for( auto &coset_values : poly_values ){
+                                for( std::size_t l = 0; l < FRI::m; l++ ){
+                                    nil::marshalling::status_type status = detail::read_marshalling_field(filled_value, iter, remaining_len);
+                                    if (status != nil::marshalling::status_type::success) {
+                                        return status;
+                                    }
+                                    coset_values[l] = filled_value.value();
+                                }
+                            }
+                        }
+                    }
+                    return nil::marshalling::status_type::success;
+                }
+
+                // Reads one query's slice of the round values section into query.round_proofs values.
+                template <typename Endianness, typename FRI, typename TIter>
+                nil::marshalling::status_type read_fri_query_round_values(
+                    TIter &iter, std::size_t &remaining_len, const std::vector<std::uint8_t> &step_list,
+                    typename FRI::query_proof_type &query
+                ){
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+
+                    field_element<TTypeBase, typename FRI::field_type::value_type> filled_value;
+                    query.round_proofs.resize(step_list.size());
+                    for( std::size_t r = 0; r < step_list.size(); r++ ){
+                        std::size_t coset_size = r == step_list.size() - 1? 1: (std::size_t(1) << (step_list[r+1]-1));
+                        query.round_proofs[r].y.resize(coset_size);
+                        for( auto &coset_values : query.round_proofs[r].y ){
+                            for( std::size_t k = 0; k < FRI::m; k++ ){
+                                nil::marshalling::status_type status = detail::read_marshalling_field(filled_value, iter, remaining_len);
+                                if (status != nil::marshalling::status_type::success) {
+                                    return status;
+                                }
+                                coset_values[k] = filled_value.value();
+                            }
+                        }
+                    }
+                    return nil::marshalling::status_type::success;
+                }
+
+                // Decodes the fri_proof encoding in one pass straight into proof, without building the
+                // intermediate bundle. Equivalent to reading fri_proof<...>::type and calling make_fri_proof.
+                template <typename Endianness, typename FRI, typename TIter>
+                nil::marshalling::status_type read_fri_proof(
+                    TIter &iter, std::size_t len, const batch_info_type &batch_info, typename FRI::proof_type &proof
+                ){
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using value_marshalling_type = field_element<TTypeBase, typename FRI::field_type::value_type>;
+
+                    std::size_t remaining_len = len;
+                    std::size_t size = 0;
+                    proof = typename FRI::proof_type();
+
+                    std::vector<std::uint8_t> step_list;
+                    nil::marshalling::status_type status = read_fri_roots_and_step_list<Endianness, FRI>(
+                        iter, remaining_len, proof.fri_roots, step_list);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+
+                    // lambda follows from the value counts, the first one that is not empty fixes it
+                    std::size_t lambda = 0;
+                    bool lambda_known = false;
+
+                    // initial polynomials values
+                    std::size_t initial_query_size = fri_query_initial_values_amount<FRI>(batch_info, step_list);
+                    status = detail::read_marshalling_sequence_size<TTypeBase, std::size_t>(iter, remaining_len, size);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    if (initial_query_size != 0) {
+                        if (size % initial_query_size != 0) {
+                            return nil::marshalling::status_type::invalid_msg_data;
+                        }
+                        lambda = size / initial_query_size;
+                        lambda_known = true;
+                        proof.query_proofs.resize(lambda);
+                    } else if (size != 0) {
+                        return nil::marshalling::status_type::invalid_msg_data;
+                    }
+                    for( std::size_t i = 0; i < lambda; i++ ){
+                        status = read_fri_query_initial_values<Endianness, FRI>(
+                            iter, remaining_len, batch_info, step_list, proof.query_proofs[i]);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                    }
+
+                    // round polynomials values
+                    std::size_t round_query_size = fri_query_round_values_amount<FRI>(step_list);
+                    status = detail::read_marshalling_sequence_size<TTypeBase, std::size_t>(iter, remaining_len, size);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    if (!lambda_known) {
+                        if (size % round_query_size != 0) {
+                            return nil::marshalling::status_type::invalid_msg_data;
+                        }
+                        lambda = size / round_query_size;
+                        proof.query_proofs.resize(lambda);
+                    } else if (size != lambda * round_query_size) {
+                        return nil::marshalling::status_type::invalid_msg_data;
+                    }
+                    for( std::size_t i = 0; i < lambda; i++ ){
+                        status = read_fri_query_round_values<Endianness, FRI>(
+                            iter, remaining_len, step_list, proof.query_proofs[i]);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                    }
+
+                    // initial merkle proofs
+                    status = detail::read_marshalling_sequence_size<TTypeBase, std::size_t>(iter, remaining_len, size);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    if (size != lambda * batch_info.size()) {
+                        return nil::marshalling::status_type::invalid_msg_data;
+                    }
+                    for( std::size_t i = 0; i < lambda; i++ ){
+                        for( const auto &it:batch_info){
+                            status = read_merkle_proof<typename FRI::merkle_proof_type, Endianness>(
+                                iter, remaining_len, proof.query_proofs[i].initial_proof[it.first].p);
+                            if (status != nil::marshalling::status_type::success) {
+                                return status;
+                            }
+                        }
+                    }
+
+                    // round merkle proofs
+                    status = detail::read_marshalling_sequence_size<TTypeBase, std::size_t>(iter, remaining_len, size);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    if (size != lambda * step_list.size()) {
+                        return nil::marshalling::status_type::invalid_msg_data;
+                    }
+                    for( std::size_t i = 0; i < lambda; i++ ){
+                        for( auto &round_proof : proof.query_proofs[i].round_proofs ){
+                            status = read_merkle_proof<typename FRI::merkle_proof_type, Endianness>(
+                                iter, remaining_len, round_proof.p);
+                            if (status != nil::marshalling::status_type::success) {
+                                return status;
+                            }
+                        }
+                    }
+
+                    // final_polynomial
+                    status = detail::read_marshalling_sequence_size<TTypeBase, std::size_t>(iter, remaining_len, size);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    std::vector<typename FRI::polynomial_type::value_type> final_polynomial(size);
+                    value_marshalling_type filled_value;
+                    for( auto &coefficient : final_polynomial ){
+                        status = detail::read_marshalling_field(filled_value, iter, remaining_len);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        coefficient = filled_value.value();
+                    }
+                    proof.final_polynomial = typename FRI::polynomial_type(std::move(final_polynomial));
+
+                    // proof_of_work
+                    nil::marshalling::types::integral<TTypeBase, typename FRI::grinding_type::output_type> filled_proof_of_work;
+                    status = detail::read_marshalling_field(filled_proof_of_work, iter, remaining_len);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    proof.proof_of_work = filled_proof_of_work.value();
+                    return status;
+                }
+
+                // Same as make_fri_proof, but the queries are reconstructed as independent tasks of executor
+                // (see detail::thread_executor), so a caller decoding many proofs can reuse its own thread pool.
+                // Each query's slice of the flat sections follows from batch_info, step_list and FRI::m, so the
+                // offsets are computed up front. Throws std::invalid_argument if the step_list is invalid or the
+                // section sizes do not match.
+                template <typename Endianness, typename FRI, typename Executor,
+                          typename = typename std::enable_if<
+                              !std::is_integral<typename std::decay<Executor>::type>::value>::type>
+                typename FRI::proof_type
+                make_fri_proof(
+                    const typename fri_proof<nil::marshalling::field_type<Endianness>, FRI>::type &filled_proof, const batch_info_type &batch_info,
+                    Executor &&executor
+                ){
+                    typename FRI::proof_type proof;
+                    make_fri_roots<Endianness, FRI>(std::get<0>(filled_proof.value()), proof);
+                    std::vector<std::uint8_t> step_list = make_fri_step_list<Endianness>(std::get<1>(filled_proof.value()));
+                    if (!fri_step_list_is_valid(step_list)) {
+                        throw std::invalid_argument("FRI proof step_list is invalid");
+                    }
+
+                    const auto &filled_initial_val = std::get<2>(filled_proof.value()).value();
+                    const auto &filled_round_val = std::get<3>(filled_proof.value()).value();
+                    const auto &filled_initial_merkle_proofs = std::get<4>(filled_proof.value()).value();
+                    const auto &filled_round_merkle_proofs = std::get<5>(filled_proof.value()).value();
+                    const std::size_t lambda = filled_round_merkle_proofs.size() / step_list.size();
+                    const std::size_t initial_query_size = fri_query_initial_values_amount<FRI>(batch_info, step_list);
+                    const std::size_t round_query_size = fri_query_round_values_amount<FRI>(step_list);
+                    if (filled_round_merkle_proofs.size() != lambda * step_list.size() ||
+                        filled_initial_merkle_proofs.size() != lambda * batch_info.size() ||
+                        filled_initial_val.size() != lambda * initial_query_size ||
+                        filled_round_val.size() != lambda * round_query_size) {
+                        throw std::invalid_argument("FRI proof section sizes mismatch");
+                    }
+
+                    proof.query_proofs.resize(lambda);
+                    const std::size_t initial_coset_size = std::size_t(1) << (step_list[0] - 1);
+                    executor(lambda, [&](std::size_t i) {
+                        auto &query_proof = proof.query_proofs[i];
+
+                        std::size_t cur = i * initial_query_size;
+                        std::size_t proof_index = i * batch_info.size();
+                        for( const auto &it:batch_info){
+                            auto &initial_proof = query_proof.initial_proof[it.first];
+                            initial_proof.values.resize(it.second);
+                            for( auto &poly_values : initial_proof.values ){
+                                poly_values.resize(initial_coset_size);
+                                for( auto &coset_values : poly_values ){
+                                    for( std::size_t l = 0; l < FRI::m; l++ ){
+                                        coset_values[l] = filled_initial_val[cur++].value();
+                                    }
+                                }
+                            }
+                            initial_proof.p = make_merkle_proof<typename FRI::merkle_proof_type, Endianness>(
+                                filled_initial_merkle_proofs[proof_index++]);
+                        }
+
+                        cur = i * round_query_size;
+                        proof_index = i * step_list.size();
+                        query_proof.round_proofs.resize(step_list.size());
+                        for( std::size_t r = 0; r < step_list.size(); r++ ){
+                            auto &round_proof = query_proof.round_proofs[r];
+                            std::size_t coset_size = r == step_list.size() - 1? 1: (std::size_t(1) << (step_list[r+1]-1));
+                            round_proof.y.resize(coset_size);
+                            for( auto &coset_values : round_proof.y ){
+                                for( std::size_t k = 0; k < FRI::m; k++ ){
+                                    coset_values[k] = filled_round_val[cur++].value();
+                                }
+                            }
+                            round_proof.p = make_merkle_proof<typename FRI::merkle_proof_type, Endianness>(
+                                filled_round_merkle_proofs[proof_index++]);
+                        }
+                    });
+
+                    proof.final_polynomial = make_fri_math_polynomial<Endianness, typename FRI::polynomial_type>(
+                        std::get<6>(filled_proof.value())
+                    );
+                    proof.proof_of_work = std::get<7>(filled_proof.value()).value();
+                    return proof;
+                }
+
+                // Same as make_fri_proof, but the queries are reconstructed concurrently on threads_amount threads
+                // started for this call, 0 meaning hardware concurrency.
+                template <typename Endianness, typename FRI>
+                typename FRI::proof_type
+                make_fri_proof(
+                    const typename fri_proof<nil::marshalling::field_type<Endianness>, FRI>::type &filled_proof, const batch_info_type &batch_info,
+                    std::size_t threads_amount
+                ){
+                    return make_fri_proof<Endianness, FRI>(filled_proof, batch_info, detail::thread_executor{threads_amount});
+                }
+
+                ///////////////////////////////////////////////////
+                // fri::proof_type marshalling without verifier-derivable round values
+                ///////////////////////////////////////////////////
+                // Opt-in variant of fri_proof: one value of a round's coset may equal the fold the verifier
+                // computes from the previous round, so it does not need to be sent. The encoding is a format tag
+                // followed by the fri_proof sections, with the round values section leaving out those values;
+                // it can only be decoded with make_fri_proof_compact and the same derivable_slot.
+
+                // Leading byte of fri_proof_compact. A big-endian fri_proof starts with the high byte of its roots
+                // count, so reading a compact encoding as fri_proof fails on the roots section.
+                constexpr static const std::uint8_t fri_proof_compact_format_tag = 0xFC;
+
+                template <typename TTypeBase, typename FRI> struct fri_proof_compact {
+                    using type = nil::marshalling::types::bundle<
+                        TTypeBase,
+                        std::tuple<
+                            // fri_proof_compact_format_tag
+                            nil::marshalling::types::integral<TTypeBase, std::uint8_t>,
+                            // fri_proof sections without the derivable round values
+                            typename fri_proof<TTypeBase, FRI>::type
+                        >
+                    >;
+                };
+
+                // derivable_slot(i, r, query_proof) returns the (coset index, value index) of round r of query i
+                // that the verifier derives, or std::nullopt if it derives none. On decoding it is called with
+                // the merkle proofs, the initial values and the rounds before r already filled.
+                // derived_value(i, r, query_proof) returns the value of that slot, computed the way the verifier
+                // does, under the same guarantees.
+                template <typename Endianness, typename FRI, typename DerivableSlot>
+                typename fri_proof_compact<nil::marshalling::field_type<Endianness>, FRI>::type
+                fill_fri_proof_compact(
+                    const typename FRI::proof_type &proof, const batch_info_type &batch_info,
+                    const typename FRI::params_type& params, DerivableSlot derivable_slot
+                ) {
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using result_type = typename fri_proof_compact<TTypeBase, FRI>::type;
+
+                    auto filled_proof = fill_fri_proof<Endianness, FRI>(proof, batch_info, params);
+
+                    std::vector<typename FRI::field_type::value_type> round_val;
+                    for( std::size_t i = 0; i < proof.query_proofs.size(); i++ ){
+                        const auto &query_proof = proof.query_proofs[i];
+                        for( std::size_t r = 0; r < query_proof.round_proofs.size(); r++ ){
+                            const auto &round_proof = query_proof.round_proofs[r];
+                            std::optional<std::pair<std::size_t, std::size_t>> slot = derivable_slot(i, r, query_proof);
+                            if (slot && (slot->first >= round_proof.y.size() || slot->second >= FRI::m)) {
+                                throw std::invalid_argument("FRI derivable round value slot out of range");
+                            }
+                            for( std::size_t k = 0; k < round_proof.y.size(); k++){
+                                for( std::size_t l = 0; l < FRI::m; l++){
+                                    if (!slot || slot->first != k || slot->second != l) {
+                                        round_val.push_back(round_proof.y[k][l]);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                    std::get<3>(filled_proof.value()) =
+                        fill_field_element_vector<typename FRI::field_type::value_type, Endianness>(round_val);
+                    return result_type(
+                        std::make_tuple(
+                            nil::marshalling::types::integral<TTypeBase, std::uint8_t>(fri_proof_compact_format_tag),
+                            filled_proof
+                        )
+                    );
+                }
+
+                template <typename Endianness, typename FRI, typename DerivableSlot, typename DerivedValue>
+                typename FRI::proof_type
+                make_fri_proof_compact(
+                    const typename fri_proof_compact<nil::marshalling::field_type<Endianness>, FRI>::type &filled_compact_proof, const batch_info_type &batch_info,
+                    DerivableSlot derivable_slot, DerivedValue derived_value
+                ){
+                    if (std::get<0>(filled_compact_proof.value()).value() != fri_proof_compact_format_tag) {
+                        throw std::invalid_argument("FRI proof is not in the compact encoding");
+                    }
+                    const auto &filled_proof = std::get<1>(filled_compact_proof.value());
+
+                    typename FRI::proof_type proof;
+                    make_fri_roots<Endianness, FRI>(std::get<0>(filled_proof.value()), proof);
+                    std::vector<std::uint8_t> step_list = make_fri_step_list<Endianness>(std::get<1>(filled_proof.value()));
+                    if (!fri_step_list_is_valid(step_list)) {
+                        throw std::invalid_argument("FRI proof step_list is invalid");
+                    }
+
+                    std::size_t lambda = std::get<5>(filled_proof.value()).value().size() / step_list.size();
+                    proof.query_proofs.resize(lambda);
+                    for( auto &query_proof : proof.query_proofs ){
+                        query_proof.round_proofs.resize(step_list.size());
+                    }
+                    make_fri_initial_values<Endianness, FRI>(std::get<2>(filled_proof.value()), batch_info, step_list, proof);
+                    make_fri_query_merkle_proofs<Endianness, FRI>(
+                        std::get<4>(filled_proof.value()), std::get<5>(filled_proof.value()), batch_info, step_list, proof);
+
+                    const auto &filled_round_val = std::get<3>(filled_proof.value()).value();
+                    std::size_t cur = 0;
+                    for( std::size_t i = 0; i < lambda; i++ ){
+                        auto &query_proof = proof.query_proofs[i];
+                        for( std::size_t r = 0; r < step_list.size(); r++ ){
+                            auto &round_proof = query_proof.round_proofs[r];
+                            std::size_t coset_size = r == step_list.size() - 1? 1: (std::size_t(1) << (step_list[r+1]-1));
+                            round_proof.y.resize(coset_size);
+                            std::optional<std::pair<std::size_t, std::size_t>> slot = derivable_slot(i, r, std::as_const(query_proof));
+                            if (slot && (slot->first >= coset_size || slot->second >= FRI::m)) {
+                                throw std::invalid_argument("FRI derivable round value slot out of range");
+                            }
+                            for( std::size_t k = 0; k < coset_size; k++){
+                                for( std::size_t l = 0; l < FRI::m; l++){
+                                    if (slot && slot->first == k && slot->second == l) {
+                                        continue;
+                                    }
+                                    if (cur >= filled_round_val.size()) {
+                                        throw std::invalid_argument("FRI proof has too few round values");
+                                    }
+                                    round_proof.y[k][l] = filled_round_val[cur++].value();
+                                }
+                            }
+                            if (slot) {
+                                round_proof.y[slot->first][slot->second] = derived_value(i, r, std::as_const(query_proof));
+                            }
+                        }
+                    }
+                    if (cur != filled_round_val.size()) {
+                        throw std::invalid_argument("FRI proof has unused round values");
+                    }
+
+                    proof.final_polynomial = make_fri_math_polynomial<Endianness, typename FRI::polynomial_type>(
+                        std::get<6>(filled_proof.value())
+                    );
+                    proof.proof_of_work = std::get<7>(filled_proof.value()).value();
+                    return proof;
+                }
+
+                ///////////////////////////////////////////////////
+                // fri::proof_type marshalling with Merkle multiproofs
+                ///////////////////////////////////////////////////
+                // Same as fri_proof, but the query Merkle proofs are stored as one merkle_multiproof per
+                // initial batch tree and one per round tree, so nodes shared by several queries are stored once.
+                template <typename TTypeBase, typename FRI> struct fri_proof_multiproof {
+                    using type = nil::marshalling::types::bundle<
+                        TTypeBase,
+                        std::tuple<
+                            // step_list.size() merkle roots
+                            fri_roots_type<TTypeBase, FRI>,
+                            // step_list
+                            fri_step_list_type<TTypeBase>,
+                            // Polynomials' values for initial proofs
+                            field_element_vector_type<TTypeBase, typename FRI::field_type::value_type>,
+                            // Polynomials' values for round proofs
+                            field_element_vector_type<TTypeBase, typename FRI::field_type::value_type>,
+                            // Merkle multiproofs for initial proofs, one per batch
+                            nil::marshalling::types::array_list<
+                                TTypeBase,
+                                types::merkle_multiproof<TTypeBase, typename FRI::merkle_proof_type>,
+                                nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                            >,
+                            // Merkle multiproofs for round proofs, one per round
+                            nil::marshalling::types::array_list<
+                                TTypeBase,
+                                types::merkle_multiproof<TTypeBase, typename FRI::merkle_proof_type>,
+                                nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                            >,
+                            // final polynomial
+                            fri_math_polynomial<TTypeBase, typename FRI::polynomial_type>,
+                            // proof of work
+                            nil::marshalling::types::integral<TTypeBase, typename FRI::grinding_type::output_type>
+                        >
+                    >;
+                };
+
+                template <typename Endianness, typename FRI>
+                typename fri_proof_multiproof<nil::marshalling::field_type<Endianness>, FRI>::type
+                fill_fri_proof_multiproof(const typename FRI::proof_type &proof, const batch_info_type &batch_info, const typename FRI::params_type& params) {
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using result_type = typename fri_proof_multiproof<TTypeBase, FRI>::type;
+
+                    std::size_t lambda = proof.query_proofs.size();
+                    std::vector<typename FRI::merkle_proof_type> tree_proofs;
+                    tree_proofs.reserve(lambda);
+
+                    typename std::tuple_element<4, typename result_type::value_type>::type filled_initial_multiproofs;
+                    for( const auto &it:batch_info){
+                        tree_proofs.clear();
+                        for( std::size_t i = 0; i < lambda; i++){
+                            tree_proofs.push_back(proof.query_proofs[i].initial_proof.at(it.first).p);
+                        }
+                        filled_initial_multiproofs.value().push_back(
+                            fill_merkle_multiproof<typename FRI::merkle_proof_type, Endianness>(tree_proofs));
+                    }
+
+                    typename std::tuple_element<5, typename result_type::value_type>::type filled_round_multiproofs;
+                    for( std::size_t r = 0; r < params.step_list.size(); r++){
+                        tree_proofs.clear();
+                        for( std::size_t i = 0; i < lambda; i++){
+                            tree_proofs.push_back(proof.query_proofs[i].round_proofs[r].p);
+                        }
+                        filled_round_multiproofs.value().push_back(
+                            fill_merkle_multiproof<typename FRI::merkle_proof_type, Endianness>(tree_proofs));
+                    }
+
+                    return result_type(
+                        std::tuple(
+                            fill_fri_roots<Endianness, FRI>(proof),
+                            fill_fri_step_list<Endianness>(params.step_list),
+                            fill_fri_initial_values<Endianness, FRI>(proof, batch_info, params),
+                            fill_fri_round_values<Endianness, FRI>(proof),
+                            filled_initial_multiproofs, filled_round_multiproofs,
+                            fill_fri_math_polynomial<Endianness, typename FRI::polynomial_type>(proof.final_polynomial),
+                            nil::marshalling::types::integral<TTypeBase, typename FRI::grinding_type::output_type>(proof.proof_of_work)
+                        )
+                    );
+                }
+
+                template <typename Endianness, typename FRI>
+                typename FRI::proof_type
+                make_fri_proof_multiproof(
+                    const typename fri_proof_multiproof<nil::marshalling::field_type<Endianness>, FRI>::type &filled_proof, const batch_info_type &batch_info
+                ){
+                    typename FRI::proof_type proof;
+                    make_fri_roots<Endianness, FRI>(std::get<0>(filled_proof.value()), proof);
+                    std::vector<std::uint8_t> step_list = make_fri_step_list<Endianness>(std::get<1>(filled_proof.value()));
+
+                    const auto &filled_initial_multiproofs = std::get<4>(filled_proof.value()).value();
+                    const auto &filled_round_multiproofs = std::get<5>(filled_proof.value()).value();
+                    if (filled_initial_multiproofs.size() != batch_info.size() || filled_round_multiproofs.size() != step_list.size()) {
+                        throw std::invalid_argument("FRI proof multiproof count mismatch");
+                    }
+                    std::size_t lambda = step_list.empty() ? 0 : std::get<1>(filled_round_multiproofs[0].value()).value().size();
+                    proof.query_proofs.resize(lambda);
+                    make_fri_initial_values<Endianness, FRI>(std::get<2>(filled_proof.value()), batch_info, step_list, proof);
+                    make_fri_round_values<Endianness, FRI>(std::get<3>(filled_proof.value()), step_list, proof);
+
+                    std::size_t cur = 0;
+                    for( const auto &it:batch_info){
+                        auto tree_proofs = make_merkle_multiproof<typename FRI::merkle_proof_type, Endianness>(
+                            filled_initial_multiproofs[cur++]);
+                        if (tree_proofs.size() != lambda) {
+                            throw std::invalid_argument("FRI proof multiproof size mismatch");
+                        }
+                        for( std::size_t i = 0; i < lambda; i++ ){
+                            proof.query_proofs[i].initial_proof[it.first].p = std::move(tree_proofs[i]);
+                        }
+                    }
+                    for( std::size_t r = 0; r < step_list.size(); r++ ){
+                        auto tree_proofs = make_merkle_multiproof<typename FRI::merkle_proof_type, Endianness>(
+                            filled_round_multiproofs[r]);
+                        if (tree_proofs.size() != lambda) {
+                            throw std::invalid_argument("FRI proof multiproof size mismatch");
+                        }
+                        for( std::size_t i = 0; i < lambda; i++ ){
+                            proof.query_proofs[i].round_proofs[r].p = std::move(tree_proofs[i]);
+                        }
+                    }
+
+                    proof.final_polynomial = make_fri_math_polynomial<Endianness, typename FRI::polynomial_type>(
+                        std::get<6>(filled_proof.value())
+                    );
+                    proof.proof_of_work = std::get<7>(filled_proof.value()).value();
+                    return proof;
+                }
             }    // namespace types
         }        // namespace marshalling
     }            // namespace crypto3
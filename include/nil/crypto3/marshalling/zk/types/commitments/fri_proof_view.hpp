@@ -0,0 +1,315 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Nil Foundation <info@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+
+#ifndef CRYPTO3_MARSHALLING_FRI_PROOF_VIEW_HPP
+#define CRYPTO3_MARSHALLING_FRI_PROOF_VIEW_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <nil/marshalling/types/integral.hpp>
+#include <nil/marshalling/status_type.hpp>
+#include <nil/marshalling/field_type.hpp>
+
+#include <nil/crypto3/marshalling/algebra/types/field_element.hpp>
+#include <nil/crypto3/marshalling/containers/types/merkle_proof.hpp>
+#include <nil/crypto3/marshalling/zk/types/commitments/fri.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace marshalling {
+            namespace types {
+                // Read-only view over a serialized fri_proof. parse() decodes the roots and step_list and
+                // builds an offset index of the remaining sections; queries are decoded on demand, so a
+                // verifier can check them one at a time or in parallel and stop at the first failure.
+                // The view does not own the bytes, they must outlive it.
+                template<typename Endianness, typename FRI>
+                class fri_proof_view {
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using value_marshalling_type = field_element<TTypeBase, typename FRI::field_type::value_type>;
+                    using node_value_marshalling_type =
+                        typename merkle_node_value<TTypeBase, typename FRI::merkle_proof_type>::type;
+
+                public:
+                    using proof_type = typename FRI::proof_type;
+                    using query_proof_type = typename FRI::query_proof_type;
+                    using commitment_type = typename FRI::commitment_type;
+                    using polynomial_type = typename FRI::polynomial_type;
+                    using proof_of_work_type = typename FRI::grinding_type::output_type;
+
+                    nil::marshalling::status_type parse(const std::uint8_t *data, std::size_t len,
+                                                        const batch_info_type &batch_info) {
+                        _data = data;
+                        _len = len;
+                        _batch_info = batch_info;
+                        _lambda = 0;
+                        _final_polynomial_size = 0;
+                        _initial_proof_offsets.clear();
+                        _round_proof_offsets.clear();
+
+                        const std::uint8_t *iter = data;
+                        std::size_t remaining_len = len;
+                        nil::marshalling::status_type status =
+                            read_fri_roots_and_step_list<Endianness, FRI>(iter, remaining_len, _fri_roots, _step_list);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+
+                        // Value sections hold fixed-size field elements, only their sizes are read here.
+                        const std::size_t value_length = value_marshalling_type().length();
+                        std::size_t initial_values_amount = 0;
+                        status = skip_values_section(iter, remaining_len, value_length, _initial_values_offset,
+                                                     initial_values_amount);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        std::size_t round_values_amount = 0;
+                        status = skip_values_section(iter, remaining_len, value_length, _round_values_offset,
+                                                     round_values_amount);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+
+                        std::size_t initial_proofs_amount = 0;
+                        status = index_merkle_proofs(iter, remaining_len, _initial_proof_offsets, initial_proofs_amount);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        std::size_t round_proofs_amount = 0;
+                        status = index_merkle_proofs(iter, remaining_len, _round_proof_offsets, round_proofs_amount);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        _lambda = round_proofs_amount / _step_list.size();
+                        if (round_proofs_amount != _lambda * _step_list.size() ||
+                            initial_proofs_amount != _lambda * _batch_info.size() ||
+                            initial_values_amount != _lambda * fri_query_initial_values_amount<FRI>(_batch_info, _step_list) ||
+                            round_values_amount != _lambda * fri_query_round_values_amount<FRI>(_step_list)) {
+                            return nil::marshalling::status_type::invalid_msg_data;
+                        }
+
+                        status = skip_values_section(iter, remaining_len, value_length, _final_polynomial_offset,
+                                                     _final_polynomial_size);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        nil::marshalling::types::integral<TTypeBase, proof_of_work_type> filled_proof_of_work;
+                        status = detail::read_marshalling_field(filled_proof_of_work, iter, remaining_len);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        _proof_of_work = filled_proof_of_work.value();
+                        return status;
+                    }
+
+                    std::size_t lambda() const {
+                        return _lambda;
+                    }
+
+                    const std::vector<commitment_type> &fri_roots() const {
+                        return _fri_roots;
+                    }
+
+                    const std::vector<std::uint8_t> &step_list() const {
+                        return _step_list;
+                    }
+
+                    proof_of_work_type proof_of_work() const {
+                        return _proof_of_work;
+                    }
+
+                    // Decodes the values and Merkle proofs of query i. Safe to call concurrently.
+                    // Returns invalid_msg_data if i is not below lambda().
+                    nil::marshalling::status_type read_query(std::size_t i, query_proof_type &query) const {
+                        if (i >= _lambda) {
+                            return nil::marshalling::status_type::invalid_msg_data;
+                        }
+                        query = query_proof_type();
+
+                        const std::size_t value_length = value_marshalling_type().length();
+                        std::size_t offset = _initial_values_offset +
+                            i * fri_query_initial_values_amount<FRI>(_batch_info, _step_list) * value_length;
+                        const std::uint8_t *iter = _data + offset;
+                        std::size_t remaining_len = _len - offset;
+                        nil::marshalling::status_type status = read_fri_query_initial_values<Endianness, FRI>(
+                            iter, remaining_len, _batch_info, _step_list, query);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+
+                        offset = _round_values_offset + i * fri_query_round_values_amount<FRI>(_step_list) * value_length;
+                        iter = _data + offset;
+                        remaining_len = _len - offset;
+                        status = read_fri_query_round_values<Endianness, FRI>(iter, remaining_len, _step_list, query);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+
+                        std::size_t proof_index = i * _batch_info.size();
+                        for (const auto &it : _batch_info) {
+                            status = read_indexed_merkle_proof(_initial_proof_offsets, proof_index++,
+                                                               query.initial_proof[it.first].p);
+                            if (status != nil::marshalling::status_type::success) {
+                                return status;
+                            }
+                        }
+                        proof_index = i * _step_list.size();
+                        for (auto &round_proof : query.round_proofs) {
+                            status = read_indexed_merkle_proof(_round_proof_offsets, proof_index++, round_proof.p);
+                            if (status != nil::marshalling::status_type::success) {
+                                return status;
+                            }
+                        }
+                        return status;
+                    }
+
+                    nil::marshalling::status_type read_final_polynomial(polynomial_type &final_polynomial) const {
+                        const std::uint8_t *iter = _data + _final_polynomial_offset;
+                        std::size_t remaining_len = _len - _final_polynomial_offset;
+                        nil::marshalling::status_type status = nil::marshalling::status_type::success;
+                        std::vector<typename polynomial_type::value_type> coefficients(_final_polynomial_size);
+                        value_marshalling_type filled_value;
+                        for (auto &coefficient : coefficients) {
+                            status = detail::read_marshalling_field(filled_value, iter, remaining_len);
+                            if (status != nil::marshalling::status_type::success) {
+                                return status;
+                            }
+                            coefficient = filled_value.value();
+                        }
+                        final_polynomial = polynomial_type(std::move(coefficients));
+                        return status;
+                    }
+
+                    // Decodes the whole proof, same result as read_fri_proof.
+                    nil::marshalling::status_type read_proof(proof_type &proof) const {
+                        proof = proof_type();
+                        proof.fri_roots.assign(_fri_roots.begin(), _fri_roots.end());
+                        proof.query_proofs.resize(_lambda);
+                        for (std::size_t i = 0; i < _lambda; i++) {
+                            nil::marshalling::status_type status = read_query(i, proof.query_proofs[i]);
+                            if (status != nil::marshalling::status_type::success) {
+                                return status;
+                            }
+                        }
+                        proof.proof_of_work = _proof_of_work;
+                        return read_final_polynomial(proof.final_polynomial);
+                    }
+
+                private:
+                    nil::marshalling::status_type skip_values_section(const std::uint8_t *&iter,
+                                                                      std::size_t &remaining_len,
+                                                                      std::size_t value_length, std::size_t &offset,
+                                                                      std::size_t &amount) const {
+                        nil::marshalling::status_type status =
+                            detail::read_marshalling_sequence_size<TTypeBase, std::size_t>(iter, remaining_len, amount);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        if (amount > remaining_len / value_length) {
+                            return nil::marshalling::status_type::not_enough_data;
+                        }
+                        offset = _len - remaining_len;
+                        iter += amount * value_length;
+                        remaining_len -= amount * value_length;
+                        return status;
+                    }
+
+                    // Records where every Merkle proof of an array_list starts, plus the end of the last one.
+                    // All nodes of a proof are assumed to have the root's length; read_indexed_merkle_proof
+                    // rejects proofs for which that does not hold.
+                    nil::marshalling::status_type index_merkle_proofs(const std::uint8_t *&iter,
+                                                                      std::size_t &remaining_len,
+                                                                      std::vector<std::size_t> &offsets,
+                                                                      std::size_t &amount) const {
+                        constexpr std::size_t arity = FRI::merkle_proof_type::arity;
+
+                        nil::marshalling::status_type status =
+                            detail::read_marshalling_sequence_size<TTypeBase, std::size_t>(iter, remaining_len, amount);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        offsets.reserve(amount + 1);
+                        nil::marshalling::types::integral<TTypeBase, std::uint64_t> filled_u64;
+                        node_value_marshalling_type filled_root;
+                        for (std::size_t i = 0; i < amount; i++) {
+                            offsets.push_back(_len - remaining_len);
+                            status = detail::read_marshalling_field(filled_u64, iter, remaining_len);
+                            if (status != nil::marshalling::status_type::success) {
+                                return status;
+                            }
+                            status = detail::read_marshalling_field(filled_root, iter, remaining_len);
+                            if (status != nil::marshalling::status_type::success) {
+                                return status;
+                            }
+                            std::size_t layers_amount = 0;
+                            status = detail::read_marshalling_sequence_size<TTypeBase, std::uint64_t>(
+                                iter, remaining_len, layers_amount);
+                            if (status != nil::marshalling::status_type::success) {
+                                return status;
+                            }
+                            const std::size_t layer_length =
+                                filled_u64.length() + (arity - 1) * (filled_u64.length() + filled_root.length());
+                            if (layers_amount > remaining_len / layer_length) {
+                                return nil::marshalling::status_type::not_enough_data;
+                            }
+                            iter += layers_amount * layer_length;
+                            remaining_len -= layers_amount * layer_length;
+                        }
+                        offsets.push_back(_len - remaining_len);
+                        return status;
+                    }
+
+                    nil::marshalling::status_type read_indexed_merkle_proof(const std::vector<std::size_t> &offsets,
+                                                                            std::size_t i,
+                                                                            typename FRI::merkle_proof_type &proof) const {
+                        const std::uint8_t *iter = _data + offsets[i];
+                        std::size_t remaining_len = offsets[i + 1] - offsets[i];
+                        nil::marshalling::status_type status =
+                            read_merkle_proof<typename FRI::merkle_proof_type, Endianness>(iter, remaining_len, proof);
+                        if (status == nil::marshalling::status_type::success && remaining_len != 0) {
+                            return nil::marshalling::status_type::invalid_msg_data;
+                        }
+                        return status;
+                    }
+
+                    const std::uint8_t *_data = nullptr;
+                    std::size_t _len = 0;
+                    batch_info_type _batch_info;
+                    std::vector<commitment_type> _fri_roots;
+                    std::vector<std::uint8_t> _step_list;
+                    std::size_t _lambda = 0;
+                    std::size_t _initial_values_offset = 0;
+                    std::size_t _round_values_offset = 0;
+                    std::size_t _final_polynomial_offset = 0;
+                    std::size_t _final_polynomial_size = 0;
+                    std::vector<std::size_t> _initial_proof_offsets;
+                    std::vector<std::size_t> _round_proof_offsets;
+                    proof_of_work_type _proof_of_work = 0;
+                };
+            }    // namespace types
+        }        // namespace marshalling
+    }            // namespace crypto3
+}    // namespace nil
+#endif    // CRYPTO3_MARSHALLING_FRI_PROOF_VIEW_HPP
@@ -28,9 +28,13 @@
 #ifndef CRYPTO3_MARSHALLING_LPC_COMMITMENT_HPP
 #define CRYPTO3_MARSHALLING_LPC_COMMITMENT_HPP
 
+#include <algorithm>
 #include <ratio>
 #include <limits>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <boost/assert.hpp>
 
@@ -45,6 +49,7 @@
 #include <nil/crypto3/marshalling/zk/types/commitments/fri.hpp>
 #include <nil/crypto3/marshalling/zk/types/commitments/eval_storage.hpp>
 #include <nil/crypto3/marshalling/containers/types/merkle_proof.hpp>
+#include <nil/crypto3/marshalling/zk/detail/parallel_for.hpp>
 
 #include <nil/crypto3/zk/commitments/type_traits.hpp>
 
@@ -157,17 +162,317 @@ namespace nil {
                 ){
                     using TTypeBase = nil::marshalling::field_type<Endianness>;
 
+                    const auto &filled_map_ids = std::get<0>(filled_commitment_preprocessed_data.value()).value();
+                    const auto &filled_sizes = std::get<1>(filled_commitment_preprocessed_data.value()).value();
+                    const auto &filled_values = std::get<2>(filled_commitment_preprocessed_data.value()).value();
+                    if (filled_map_ids.size() != filled_sizes.size()) {
+                        throw std::invalid_argument("LPC preprocessed data has mismatched ids and sizes");
+                    }
+
                     typename LPCScheme::preprocessed_data_type result;
-                    for(std::size_t i = 0; i < std::get<0>(filled_commitment_preprocessed_data.value()).value().size(); i++){
-                        std::size_t k = std::get<0>(filled_commitment_preprocessed_data.value()).value()[i].value();
-                        std::size_t size = std::get<1>(filled_commitment_preprocessed_data.value()).value()[i].value();
+                    std::size_t offset = 0;
+                    for(std::size_t i = 0; i < filled_map_ids.size(); i++){
+                        std::size_t k = filled_map_ids[i].value();
+                        std::size_t size = filled_sizes[i].value();
+                        if (size > filled_values.size() - offset) {
+                            throw std::invalid_argument("LPC preprocessed data has fewer values than sizes declare");
+                        }
                         std::vector<typename LPCScheme::field_type::value_type> v;
+                        v.reserve(size);
                         for(std::size_t j = 0; j < size; j++){
-                            v.push_back(std::get<2>(filled_commitment_preprocessed_data.value()).value()[i*size + j].value());
+                            v.push_back(filled_values[offset + j].value());
                         }
-                        result[k] = v;
+                        offset += size;
+                        result[k] = std::move(v);
+                    }
+                    if (offset != filled_values.size()) {
+                        throw std::invalid_argument("LPC preprocessed data has more values than sizes declare");
+                    }
+                    return result;
+                }
+
+                // Offset-indexed LPC preprocessed data: map ids, a cumulative offset table with one entry more
+                // than there are ids, and the flat value array. Entry i owns values [offsets[i], offsets[i + 1]).
+                // Values have a fixed length, so entries can be located and decoded independently, see
+                // commitment_preprocessed_data_view.
+                template <typename TTypeBase, typename LPCScheme>
+                using commitment_preprocessed_data_indexed = nil::marshalling::types::bundle<
+                    TTypeBase,
+                    std::tuple<
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            nil::marshalling::types::integral<TTypeBase, std::size_t>,
+                            nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >,
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            nil::marshalling::types::integral<TTypeBase, std::size_t>,
+                            nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >,
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            field_element<TTypeBase, typename LPCScheme::field_type::value_type>,
+                            nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >
+                    >
+                >;
+
+                template <typename Endianness, typename LPCScheme>
+                typename std::enable_if<nil::crypto3::zk::is_lpc<LPCScheme>,
+                                        commitment_preprocessed_data_indexed<nil::marshalling::field_type<Endianness>, LPCScheme>>::type
+                fill_commitment_preprocessed_data_indexed(const typename LPCScheme::preprocessed_data_type &lpc_data){
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using integral_type = nil::marshalling::types::integral<TTypeBase, std::size_t>;
+                    using field_marshalling_type = field_element<TTypeBase, typename LPCScheme::field_type::value_type>;
+
+                    commitment_preprocessed_data_indexed<TTypeBase, LPCScheme> result;
+                    auto &filled_map_ids = std::get<0>(result.value()).value();
+                    auto &filled_offsets = std::get<1>(result.value()).value();
+                    auto &filled_values = std::get<2>(result.value()).value();
+
+                    std::size_t values_amount = 0;
+                    for(const auto&[k, v]:lpc_data){
+                        values_amount += v.size();
                     }
+                    filled_map_ids.reserve(lpc_data.size());
+                    filled_offsets.reserve(lpc_data.size() + 1);
+                    filled_values.reserve(values_amount);
 
+                    filled_offsets.push_back(integral_type(0));
+                    for(const auto&[k, v]:lpc_data){
+                        filled_map_ids.push_back(integral_type(k));
+                        for(std::size_t i = 0; i < v.size(); i++){
+                            filled_values.push_back(field_marshalling_type(v[i]));
+                        }
+                        filled_offsets.push_back(integral_type(filled_values.size()));
+                    }
+                    return result;
+                }
+
+                // Read-only view over serialized commitment_preprocessed_data_indexed. parse() decodes the ids
+                // and offsets only; values are decoded on demand from the buffer, which must outlive the view.
+                template <typename Endianness, typename LPCScheme>
+                class commitment_preprocessed_data_view {
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using integral_type = nil::marshalling::types::integral<TTypeBase, std::size_t>;
+                    using id_list_type = nil::marshalling::types::array_list<
+                        TTypeBase,
+                        integral_type,
+                        nil::marshalling::option::sequence_size_field_prefix<integral_type>
+                    >;
+
+                public:
+                    using value_type = typename LPCScheme::field_type::value_type;
+                    using value_marshalling_type = field_element<TTypeBase, value_type>;
+
+                    // Decoding of fewer values than this is not split between threads.
+                    constexpr static const std::size_t parallel_threshold = 1 << 12;
+
+                    // Serialized values of one entry.
+                    class values_span {
+                    public:
+                        values_span(const std::uint8_t *data, std::size_t size, std::size_t element_len) :
+                            _data(data), _size(size), _element_len(element_len) {
+                        }
+
+                        std::size_t size() const {
+                            return _size;
+                        }
+
+                        value_type operator[](std::size_t i) const {
+                            BOOST_ASSERT(i < _size);
+                            value_marshalling_type filled_value;
+                            const std::uint8_t *iter = _data + i * _element_len;
+                            filled_value.read(iter, _element_len);
+                            return filled_value.value();
+                        }
+
+                        // Appends the values to out after a single reserve.
+                        void read(std::vector<value_type> &out) const {
+                            out.reserve(out.size() + _size);
+                            for (std::size_t i = 0; i < _size; i++) {
+                                out.push_back((*this)[i]);
+                            }
+                        }
+
+                    private:
+                        const std::uint8_t *_data;
+                        std::size_t _size;
+                        std::size_t _element_len;
+                    };
+
+                    nil::marshalling::status_type parse(const std::uint8_t *data, std::size_t len) {
+                        const std::uint8_t *iter = data;
+                        id_list_type filled_map_ids;
+                        nil::marshalling::status_type status = filled_map_ids.read(iter, len);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        std::size_t remaining_len = len - filled_map_ids.length();
+
+                        id_list_type filled_offsets;
+                        status = filled_offsets.read(iter, remaining_len);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        remaining_len -= filled_offsets.length();
+
+                        integral_type filled_values_amount;
+                        status = filled_values_amount.read(iter, remaining_len);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        remaining_len -= filled_values_amount.length();
+
+                        const std::size_t values_amount = filled_values_amount.value();
+                        if (filled_offsets.value().size() != filled_map_ids.value().size() + 1 ||
+                            filled_offsets.value().front().value() != 0 ||
+                            filled_offsets.value().back().value() != values_amount) {
+                            return nil::marshalling::status_type::invalid_msg_data;
+                        }
+                        const std::size_t element_len = value_marshalling_type(value_type::zero()).length();
+                        if (values_amount > remaining_len / element_len) {
+                            return nil::marshalling::status_type::not_enough_data;
+                        }
+
+                        std::vector<std::size_t> ids;
+                        std::vector<std::size_t> offsets;
+                        ids.reserve(filled_map_ids.value().size());
+                        offsets.reserve(filled_offsets.value().size());
+                        for (const auto &id : filled_map_ids.value()) {
+                            ids.push_back(id.value());
+                        }
+                        for (const auto &offset : filled_offsets.value()) {
+                            if (!offsets.empty() && offset.value() < offsets.back()) {
+                                return nil::marshalling::status_type::invalid_msg_data;
+                            }
+                            offsets.push_back(offset.value());
+                        }
+
+                        _ids = std::move(ids);
+                        _offsets = std::move(offsets);
+                        _values = iter;
+                        _element_len = element_len;
+                        return nil::marshalling::status_type::success;
+                    }
+
+                    std::size_t size() const {
+                        return _ids.size();
+                    }
+
+                    const std::vector<std::size_t> &batch_ids() const {
+                        return _ids;
+                    }
+
+                    // Values of the i-th entry in serialization order.
+                    values_span entry(std::size_t i) const {
+                        BOOST_ASSERT(i < size());
+                        return values_span(_values + _offsets[i] * _element_len, _offsets[i + 1] - _offsets[i],
+                                           _element_len);
+                    }
+
+                    // Values of the entry with the given batch id. Throws std::out_of_range if there is none.
+                    values_span batch(std::size_t batch_id) const {
+                        for (std::size_t i = 0; i < _ids.size(); i++) {
+                            if (_ids[i] == batch_id) {
+                                return entry(i);
+                            }
+                        }
+                        throw std::out_of_range("No such batch in LPC preprocessed data");
+                    }
+
+                    // Decodes all entries, splitting the values between threads_amount threads
+                    // (0 means hardware concurrency) when there are enough of them.
+                    typename LPCScheme::preprocessed_data_type read(std::size_t threads_amount = 1) const {
+                        typename LPCScheme::preprocessed_data_type result;
+                        if (_offsets.empty()) {
+                            return result;
+                        }
+                        std::vector<value_type *> entries(_ids.size());
+                        for (std::size_t i = 0; i < _ids.size(); i++) {
+                            auto &v = result[_ids[i]];
+                            v.resize(_offsets[i + 1] - _offsets[i]);
+                            entries[i] = v.data();
+                        }
+                        if (result.size() != _ids.size()) {
+                            throw std::invalid_argument("LPC preprocessed data has duplicate batch ids");
+                        }
+
+                        const std::size_t values_amount = _offsets.back();
+                        if (values_amount < parallel_threshold) {
+                            threads_amount = 1;
+                        }
+                        detail::parallel_for(0, values_amount, threads_amount, [&](std::size_t first, std::size_t last) {
+                            std::size_t i = std::upper_bound(_offsets.begin(), _offsets.end(), first) - _offsets.begin() - 1;
+                            for (std::size_t j = first; j < last; j++) {
+                                while (j >= _offsets[i + 1]) {
+                                    i++;
+                                }
+                                value_marshalling_type filled_value;
+                                const std::uint8_t *iter = _values + j * _element_len;
+                                filled_value.read(iter, _element_len);
+                                entries[i][j - _offsets[i]] = filled_value.value();
+                            }
+                        });
+                        return result;
+                    }
+
+                private:
+                    std::vector<std::size_t> _ids;
+                    std::vector<std::size_t> _offsets;
+                    const std::uint8_t *_values = nullptr;
+                    std::size_t _element_len = 0;
+                };
+
+                // Throws std::invalid_argument if the offset table does not match the values.
+                template <typename Endianness, typename LPCScheme>
+                typename std::enable_if<nil::crypto3::zk::is_lpc<LPCScheme>, typename LPCScheme::preprocessed_data_type>::type
+                make_commitment_preprocessed_data_indexed(
+                    const commitment_preprocessed_data_indexed<nil::marshalling::field_type<Endianness>, LPCScheme> &filled_data,
+                    std::size_t threads_amount = 1
+                ){
+                    using value_type = typename LPCScheme::field_type::value_type;
+
+                    const auto &filled_map_ids = std::get<0>(filled_data.value()).value();
+                    const auto &filled_offsets = std::get<1>(filled_data.value()).value();
+                    const auto &filled_values = std::get<2>(filled_data.value()).value();
+                    if (filled_offsets.size() != filled_map_ids.size() + 1 || filled_offsets.front().value() != 0 ||
+                        filled_offsets.back().value() != filled_values.size()) {
+                        throw std::invalid_argument("Malformed LPC preprocessed data offsets");
+                    }
+
+                    typename LPCScheme::preprocessed_data_type result;
+                    std::vector<std::pair<value_type *, std::size_t>> entries;
+                    entries.reserve(filled_map_ids.size());
+                    for (std::size_t i = 0; i < filled_map_ids.size(); i++) {
+                        const std::size_t first = filled_offsets[i].value();
+                        const std::size_t last = filled_offsets[i + 1].value();
+                        if (last < first) {
+                            throw std::invalid_argument("Malformed LPC preprocessed data offsets");
+                        }
+                        auto &v = result[filled_map_ids[i].value()];
+                        v.resize(last - first);
+                        entries.emplace_back(v.data(), first);
+                    }
+                    if (result.size() != filled_map_ids.size()) {
+                        throw std::invalid_argument("LPC preprocessed data has duplicate batch ids");
+                    }
+
+                    if (filled_values.size() < commitment_preprocessed_data_view<Endianness, LPCScheme>::parallel_threshold) {
+                        threads_amount = 1;
+                    }
+                    detail::parallel_for(0, filled_values.size(), threads_amount, [&](std::size_t first, std::size_t last) {
+                        std::size_t i = 0;
+                        while (i + 1 < entries.size() && filled_offsets[i + 1].value() <= first) {
+                            i++;
+                        }
+                        for (std::size_t j = first; j < last; j++) {
+                            while (j >= filled_offsets[i + 1].value()) {
+                                i++;
+                            }
+                            entries[i].first[j - entries[i].second] = filled_values[j].value();
+                        }
+                    });
                     return result;
                 }
 
@@ -27,9 +27,14 @@
 #ifndef CRYPTO3_MARSHALLING_COMMON_DATA_HPP
 #define CRYPTO3_MARSHALLING_COMMON_DATA_HPP
 
+#include <cstdint>
+#include <iterator>
+#include <map>
 #include <ratio>
 #include <limits>
+#include <stdexcept>
 #include <type_traits>
+#include <vector>
 
 #include <nil/marshalling/types/bundle.hpp>
 #include <nil/marshalling/types/array_list.hpp>
@@ -44,11 +49,146 @@
 #include <nil/crypto3/marshalling/zk/types/commitments/kzg.hpp>
 #include <nil/crypto3/marshalling/zk/types/commitments/lpc.hpp>
 #include <nil/crypto3/marshalling/containers/types/merkle_proof.hpp>
+#include <nil/crypto3/marshalling/zk/detail/varint.hpp>
 
 namespace nil {
     namespace crypto3 {
         namespace marshalling {
             namespace types {
+                // ******************* compact columns rotations ********************************* //
+                // Varint bytes: the number of distinct rotation sets, each set as its size, the zigzag first
+                // rotation and the gaps minus one between consecutive rotations; then the number of columns
+                // and the index of each column's set. Rotations repeat heavily between columns, so this is
+                // much shorter than the nested list in placeholder_common_data.
+                template<typename TTypeBase>
+                using columns_rotations_compact = nil::marshalling::types::array_list<
+                    TTypeBase,
+                    nil::marshalling::types::integral<TTypeBase, std::uint8_t>,
+                    nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                >;
+
+                template<typename Endianness, typename ColumnsRotationsType>
+                columns_rotations_compact<nil::marshalling::field_type<Endianness>>
+                fill_columns_rotations_compact(const ColumnsRotationsType &columns_rotations) {
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using octet_marshalling_type = nil::marshalling::types::integral<TTypeBase, std::uint8_t>;
+                    using rotations_type = typename ColumnsRotationsType::value_type;
+
+                    std::map<rotations_type, std::size_t> dictionary_indices;
+                    std::vector<const rotations_type *> dictionary;
+                    std::vector<std::size_t> column_indices;
+                    column_indices.reserve(columns_rotations.size());
+                    for (const auto &rotations : columns_rotations) {
+                        auto it = dictionary_indices.emplace(rotations, dictionary.size());
+                        if (it.second) {
+                            dictionary.push_back(&it.first->first);
+                        }
+                        column_indices.push_back(it.first->second);
+                    }
+
+                    std::vector<std::uint8_t> bytes;
+                    auto out = std::back_inserter(bytes);
+                    detail::write_varint(dictionary.size(), out);
+                    for (const auto *rotations : dictionary) {
+                        detail::write_varint(rotations->size(), out);
+                        std::int64_t previous = 0;
+                        bool first = true;
+                        for (const auto rotation : *rotations) {
+                            if (first) {
+                                detail::write_varint(detail::zigzag_encode(rotation), out);
+                                first = false;
+                            } else {
+                                detail::write_varint(std::uint64_t(std::int64_t(rotation) - previous - 1), out);
+                            }
+                            previous = rotation;
+                        }
+                    }
+                    detail::write_varint(column_indices.size(), out);
+                    for (const auto index : column_indices) {
+                        detail::write_varint(index, out);
+                    }
+
+                    columns_rotations_compact<TTypeBase> filled;
+                    filled.value().reserve(bytes.size());
+                    for (const std::uint8_t byte : bytes) {
+                        filled.value().push_back(octet_marshalling_type(byte));
+                    }
+                    return filled;
+                }
+
+                // Decodes every distinct set once from sorted rotations and copies it into its columns.
+                // Throws std::invalid_argument on malformed data.
+                template<typename Endianness, typename ColumnsRotationsType>
+                ColumnsRotationsType make_columns_rotations_compact(
+                    const columns_rotations_compact<nil::marshalling::field_type<Endianness>> &filled
+                ) {
+                    using rotations_type = typename ColumnsRotationsType::value_type;
+                    using rotation_type = typename rotations_type::value_type;
+
+                    std::vector<std::uint8_t> bytes;
+                    bytes.reserve(filled.value().size());
+                    for (const auto &byte : filled.value()) {
+                        bytes.push_back(byte.value());
+                    }
+                    auto iter = bytes.cbegin();
+                    auto read_value = [&iter, &bytes]() {
+                        std::uint64_t value = 0;
+                        if (!detail::read_varint(iter, bytes.cend(), value)) {
+                            throw std::invalid_argument("Invalid varint in compact columns rotations");
+                        }
+                        return value;
+                    };
+                    // Every entry takes at least one byte, which bounds the sizes before allocating.
+                    auto read_size = [&read_value, &bytes]() {
+                        std::uint64_t value = read_value();
+                        if (value > bytes.size()) {
+                            throw std::invalid_argument("Compact columns rotations are too short");
+                        }
+                        return value;
+                    };
+                    auto check_rotation = [](std::int64_t value) {
+                        if (value < std::numeric_limits<rotation_type>::min() ||
+                            value > std::numeric_limits<rotation_type>::max()) {
+                            throw std::invalid_argument("Rotation out of range in compact columns rotations");
+                        }
+                        return rotation_type(value);
+                    };
+
+                    std::vector<rotations_type> dictionary(read_size());
+                    std::vector<rotation_type> sorted_rotations;
+                    for (auto &rotations : dictionary) {
+                        const std::size_t size = read_size();
+                        sorted_rotations.clear();
+                        sorted_rotations.reserve(size);
+                        for (std::size_t i = 0; i < size; i++) {
+                            if (i == 0) {
+                                sorted_rotations.push_back(check_rotation(detail::zigzag_decode(read_value())));
+                            } else {
+                                const std::uint64_t gap = read_value();
+                                if (gap > std::uint64_t(std::numeric_limits<std::uint32_t>::max())) {
+                                    throw std::invalid_argument("Rotation out of range in compact columns rotations");
+                                }
+                                sorted_rotations.push_back(
+                                    check_rotation(std::int64_t(sorted_rotations.back()) + std::int64_t(gap) + 1));
+                            }
+                        }
+                        rotations = rotations_type(sorted_rotations.begin(), sorted_rotations.end());
+                    }
+
+                    ColumnsRotationsType columns_rotations(read_size());
+                    for (auto &rotations : columns_rotations) {
+                        const std::uint64_t index = read_value();
+                        if (index >= dictionary.size()) {
+                            throw std::invalid_argument("Invalid rotation set index in compact columns rotations");
+                        }
+                        rotations = dictionary[index];
+                    }
+                    if (iter != bytes.cend()) {
+                        throw std::invalid_argument("Compact columns rotations have trailing bytes");
+                    }
+                    return columns_rotations;
+                }
+
                 // ******************* placeholder common data ********************************* //
                 template<typename TTypeBase, typename CommonDataType>
                 using placeholder_common_data = nil::marshalling::types::bundle<
@@ -213,9 +353,10 @@ namespace nil {
                         std::get<1>(filled_common_data.value()).value().size()
                     );
                     for(size_t i = 0; i < std::get<1>(filled_common_data.value()).value().size(); i++){
-                        auto filled_column = std::get<1>(filled_common_data.value()).value().at(i);
+                        const auto &filled_column = std::get<1>(filled_common_data.value()).value().at(i);
                         for(size_t j = 0; j < filled_column.value().size(); j++) {
-                            columns_rotations[i].insert(filled_column.value()[j].value());
+                            // Rotations are written in ascending order, so the hint makes each insert constant time.
+                            columns_rotations[i].insert(columns_rotations[i].end(), filled_column.value()[j].value());
                         }
                     }
 
@@ -0,0 +1,178 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Nil Foundation <info@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+
+#ifndef CRYPTO3_MARSHALLING_COMMON_DATA_CACHE_HPP
+#define CRYPTO3_MARSHALLING_COMMON_DATA_CACHE_HPP
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include <nil/marshalling/field_type.hpp>
+#include <nil/marshalling/status_type.hpp>
+
+#include <nil/crypto3/hash/algorithm/hash.hpp>
+#include <nil/crypto3/hash/hash_state.hpp>
+#include <nil/crypto3/hash/sha2.hpp>
+
+#include <nil/crypto3/marshalling/zk/types/placeholder/common_data.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace marshalling {
+            namespace types {
+                // Thread-safe LRU cache of deserialized placeholder common data, keyed by the Hash digest of the
+                // serialized placeholder_common_data or by a caller-provided key of the same type. Entries are
+                // shared and immutable. A miss builds the common data outside the lock, so concurrent misses on
+                // the same key may build it twice; the first one inserted is kept.
+                template<typename Endianness, typename CommonDataType, typename Hash = nil::crypto3::hashes::sha2<256>>
+                class placeholder_common_data_cache {
+                public:
+                    using key_type = typename Hash::digest_type;
+                    using value_type = std::shared_ptr<const CommonDataType>;
+                    using filled_type = placeholder_common_data<nil::marshalling::field_type<Endianness>, CommonDataType>;
+
+                    explicit placeholder_common_data_cache(std::size_t capacity = 16) : _capacity(capacity) {
+                        if (capacity == 0) {
+                            throw std::invalid_argument("Common data cache capacity must be positive");
+                        }
+                    }
+
+                    static key_type digest(const std::uint8_t *data, std::size_t len) {
+                        nil::crypto3::accumulator_set<Hash> acc;
+                        nil::crypto3::hash<Hash>(data, data + len, acc);
+                        return nil::crypto3::accumulators::extract::hash<Hash>(acc);
+                    }
+
+                    // Returns the common data serialized in [data, data + len), deserializing it on a miss.
+                    // Throws std::invalid_argument if the bytes cannot be read.
+                    value_type get(const std::uint8_t *data, std::size_t len) {
+                        return get_or_build(digest(data, len), [data, len]() {
+                            filled_type filled;
+                            const std::uint8_t *iter = data;
+                            if (filled.read(iter, len) != nil::marshalling::status_type::success) {
+                                throw std::invalid_argument("Invalid serialized placeholder common data");
+                            }
+                            return make_placeholder_common_data<Endianness, CommonDataType>(filled);
+                        });
+                    }
+
+                    // Returns the common data cached under key, making it from filled on a miss.
+                    value_type get(const key_type &key, const filled_type &filled) {
+                        return get_or_build(key, [&filled]() {
+                            return make_placeholder_common_data<Endianness, CommonDataType>(filled);
+                        });
+                    }
+
+                    // Returns the common data cached under key, or nullptr. Counts as a hit or a miss.
+                    value_type find(const key_type &key) {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        return find_locked(key);
+                    }
+
+                    std::size_t capacity() const {
+                        return _capacity;
+                    }
+
+                    std::size_t size() const {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        return _entries.size();
+                    }
+
+                    std::size_t hits() const {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        return _hits;
+                    }
+
+                    std::size_t misses() const {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        return _misses;
+                    }
+
+                    // Drops all entries and resets the counters.
+                    void clear() {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _entries.clear();
+                        _index.clear();
+                        _hits = 0;
+                        _misses = 0;
+                    }
+
+                private:
+                    using entry_list_type = std::list<std::pair<key_type, value_type>>;
+
+                    template<typename Builder>
+                    value_type get_or_build(const key_type &key, Builder &&builder) {
+                        {
+                            std::lock_guard<std::mutex> lock(_mutex);
+                            value_type cached = find_locked(key);
+                            if (cached) {
+                                return cached;
+                            }
+                        }
+                        value_type built = std::make_shared<const CommonDataType>(builder());
+
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        auto it = _index.find(key);
+                        if (it != _index.end()) {
+                            _entries.splice(_entries.begin(), _entries, it->second);
+                            return it->second->second;
+                        }
+                        _entries.emplace_front(key, built);
+                        _index.emplace(key, _entries.begin());
+                        if (_entries.size() > _capacity) {
+                            _index.erase(_entries.back().first);
+                            _entries.pop_back();
+                        }
+                        return built;
+                    }
+
+                    value_type find_locked(const key_type &key) {
+                        auto it = _index.find(key);
+                        if (it == _index.end()) {
+                            _misses++;
+                            return nullptr;
+                        }
+                        _hits++;
+                        _entries.splice(_entries.begin(), _entries, it->second);
+                        return it->second->second;
+                    }
+
+                    const std::size_t _capacity;
+                    mutable std::mutex _mutex;
+                    entry_list_type _entries;
+                    std::map<key_type, typename entry_list_type::iterator> _index;
+                    std::size_t _hits = 0;
+                    std::size_t _misses = 0;
+                };
+            }    // namespace types
+        }        // namespace marshalling
+    }            // namespace crypto3
+}    // namespace nil
+#endif    // CRYPTO3_MARSHALLING_COMMON_DATA_CACHE_HPP
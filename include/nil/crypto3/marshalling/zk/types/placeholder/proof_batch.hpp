@@ -0,0 +1,558 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Nil Foundation <info@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+
+#ifndef CRYPTO3_MARSHALLING_PLACEHOLDER_PROOF_BATCH_HPP
+#define CRYPTO3_MARSHALLING_PLACEHOLDER_PROOF_BATCH_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <nil/marshalling/types/bundle.hpp>
+#include <nil/marshalling/types/array_list.hpp>
+#include <nil/marshalling/types/integral.hpp>
+#include <nil/marshalling/status_type.hpp>
+#include <nil/marshalling/options.hpp>
+#include <nil/marshalling/field_type.hpp>
+
+#include <nil/crypto3/zk/commitments/type_traits.hpp>
+
+#include <nil/crypto3/marshalling/algebra/types/field_element.hpp>
+#include <nil/crypto3/marshalling/containers/types/merkle_proof.hpp>
+#include <nil/crypto3/marshalling/zk/types/commitments/fri.hpp>
+#include <nil/crypto3/marshalling/zk/types/placeholder/proof.hpp>
+#include <nil/crypto3/marshalling/zk/detail/field_writer.hpp>
+#include <nil/crypto3/marshalling/zk/detail/parallel_for.hpp>
+#include <nil/crypto3/marshalling/zk/detail/varint.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace marshalling {
+            namespace types {
+                // Structure shared by all LPC placeholder proofs of one circuit: which batches are committed,
+                // the eval_storage batch layout, the number of FRI queries and the FRI step_list.
+                struct placeholder_proof_batch_layout {
+                    std::vector<std::size_t> commitment_batches;
+                    // (batch id, polynomials amount), in eval_storage order
+                    std::vector<std::pair<std::size_t, std::size_t>> batches;
+                    // evaluation points number of every polynomial, batch by batch
+                    std::vector<std::size_t> points;
+                    std::size_t lambda = 0;
+                    std::vector<std::uint8_t> step_list;
+
+                    batch_info_type batch_info() const {
+                        batch_info_type result;
+                        for (const auto &batch : batches) {
+                            result[batch.first] = batch.second;
+                        }
+                        return result;
+                    }
+
+                    bool operator==(const placeholder_proof_batch_layout &other) const {
+                        return commitment_batches == other.commitment_batches && batches == other.batches &&
+                               points == other.points && lambda == other.lambda && step_list == other.step_list;
+                    }
+
+                    bool operator!=(const placeholder_proof_batch_layout &other) const {
+                        return !(*this == other);
+                    }
+                };
+
+                // Many LPC placeholder proofs of one circuit. The layout is stored once as LEB128 varints;
+                // every proof is packed without size prefixes the layout already implies, using fixed-size
+                // Merkle nodes and compact Merkle proofs. Proof i occupies payload[offsets[i], offsets[i + 1]),
+                // so proofs can be decoded independently.
+                template<typename TTypeBase, typename Proof>
+                using placeholder_proof_batch = nil::marshalling::types::bundle<
+                    TTypeBase,
+                    std::tuple<
+                        // layout
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            nil::marshalling::types::integral<TTypeBase, std::uint8_t>,
+                            nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >,
+                        // payload offsets, proofs amount + 1
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            nil::marshalling::types::integral<TTypeBase, std::uint64_t>,
+                            nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >,
+                        // payload
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            nil::marshalling::types::integral<TTypeBase, std::uint8_t>,
+                            nil::marshalling::option::sequence_size_field_prefix<nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >
+                    >
+                >;
+
+                template<typename Proof, typename CommitmentParamsType>
+                placeholder_proof_batch_layout make_placeholder_proof_batch_layout(
+                    const Proof &proof, const CommitmentParamsType &commitment_params) {
+
+                    placeholder_proof_batch_layout layout;
+                    for (const auto &it : proof.commitments) {
+                        layout.commitment_batches.push_back(it.first);
+                    }
+                    const auto &z = proof.eval_proof.eval_proof.z;
+                    for (const auto batch : z.get_batches()) {
+                        layout.batches.emplace_back(batch, z.get_batch_size(batch));
+                        for (std::size_t j = 0; j < z.get_batch_size(batch); j++) {
+                            layout.points.push_back(z.get_poly_points_number(batch, j));
+                        }
+                    }
+                    layout.lambda = proof.eval_proof.eval_proof.fri_proof.query_proofs.size();
+                    for (const auto step : commitment_params.step_list) {
+                        layout.step_list.push_back(step);
+                    }
+                    return layout;
+                }
+            }    // namespace types
+
+            namespace detail {
+                template<typename Endianness, typename Proof, typename Writer>
+                nil::marshalling::status_type write_placeholder_proof_batch_entry(
+                    const Proof &proof, const types::placeholder_proof_batch_layout &layout, Writer &writer) {
+
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using commitment_scheme_type = typename Proof::commitment_scheme_type;
+                    using FRI = typename commitment_scheme_type::basic_fri;
+                    using value_marshalling_type = types::field_element<TTypeBase, typename Proof::field_type::value_type>;
+                    using fri_value_marshalling_type = types::field_element<TTypeBase, typename FRI::field_type::value_type>;
+
+                    const auto &z = proof.eval_proof.eval_proof.z;
+                    const auto &fri_proof = proof.eval_proof.eval_proof.fri_proof;
+                    const types::batch_info_type batch_info = layout.batch_info();
+                    const std::size_t initial_coset_size = std::size_t(1) << (layout.step_list[0] - 1);
+
+                    nil::marshalling::status_type status = nil::marshalling::status_type::success;
+                    auto write = [&writer, &status](const auto &field) {
+                        if (status == nil::marshalling::status_type::success) {
+                            status = writer.write(field);
+                        }
+                    };
+
+                    for (const auto batch : layout.commitment_batches) {
+                        write(types::fill_merkle_node_value_fixed<typename commitment_scheme_type::commitment_type, Endianness>(
+                            proof.commitments.at(batch)));
+                    }
+                    write(value_marshalling_type(proof.eval_proof.challenge));
+
+                    for (const auto &batch : layout.batches) {
+                        for (std::size_t j = 0; j < batch.second; j++) {
+                            for (std::size_t k = 0; k < z.get_poly_points_number(batch.first, j); k++) {
+                                write(value_marshalling_type(z.get(batch.first, j, k)));
+                            }
+                        }
+                    }
+
+                    if (fri_proof.fri_roots.size() != layout.step_list.size()) {
+                        throw std::invalid_argument("Placeholder proof does not match the batch layout");
+                    }
+                    for (const auto &root : fri_proof.fri_roots) {
+                        write(types::fill_merkle_node_value_fixed<typename FRI::commitment_type, Endianness>(root));
+                    }
+                    for (const auto &query_proof : fri_proof.query_proofs) {
+                        for (const auto &it : batch_info) {
+                            const auto &values = query_proof.initial_proof.at(it.first).values;
+                            if (values.size() != it.second) {
+                                throw std::invalid_argument("Placeholder proof does not match the batch layout");
+                            }
+                            for (const auto &poly_values : values) {
+                                if (poly_values.size() != initial_coset_size) {
+                                    throw std::invalid_argument("Placeholder proof does not match the batch layout");
+                                }
+                                for (const auto &coset_values : poly_values) {
+                                    for (std::size_t l = 0; l < FRI::m; l++) {
+                                        write(fri_value_marshalling_type(coset_values[l]));
+                                    }
+                                }
+                            }
+                        }
+                    }
+                    for (const auto &query_proof : fri_proof.query_proofs) {
+                        if (query_proof.round_proofs.size() != layout.step_list.size()) {
+                            throw std::invalid_argument("Placeholder proof does not match the batch layout");
+                        }
+                        for (std::size_t r = 0; r < layout.step_list.size(); r++) {
+                            const std::size_t coset_size =
+                                r == layout.step_list.size() - 1 ? 1 : (std::size_t(1) << (layout.step_list[r + 1] - 1));
+                            if (query_proof.round_proofs[r].y.size() != coset_size) {
+                                throw std::invalid_argument("Placeholder proof does not match the batch layout");
+                            }
+                            for (const auto &coset_values : query_proof.round_proofs[r].y) {
+                                for (std::size_t k = 0; k < FRI::m; k++) {
+                                    write(fri_value_marshalling_type(coset_values[k]));
+                                }
+                            }
+                        }
+                    }
+                    for (const auto &query_proof : fri_proof.query_proofs) {
+                        for (const auto &it : batch_info) {
+                            write(types::fill_merkle_proof_compact<typename FRI::merkle_proof_type, Endianness>(
+                                query_proof.initial_proof.at(it.first).p));
+                        }
+                    }
+                    for (const auto &query_proof : fri_proof.query_proofs) {
+                        for (const auto &round_proof : query_proof.round_proofs) {
+                            write(types::fill_merkle_proof_compact<typename FRI::merkle_proof_type, Endianness>(round_proof.p));
+                        }
+                    }
+                    write(types::fill_fri_math_polynomial<Endianness, typename FRI::polynomial_type>(fri_proof.final_polynomial));
+                    write(nil::marshalling::types::integral<TTypeBase, typename FRI::grinding_type::output_type>(
+                        fri_proof.proof_of_work));
+                    return status;
+                }
+
+                template<typename Field, typename TIter>
+                void read_placeholder_proof_batch_field(Field &field, TIter &iter, std::size_t &remaining_len) {
+                    if (read_marshalling_field(field, iter, remaining_len) != nil::marshalling::status_type::success) {
+                        throw std::invalid_argument("Placeholder proof batch entry is truncated or malformed");
+                    }
+                }
+
+                template<typename Endianness, typename Proof>
+                Proof read_placeholder_proof_batch_entry(
+                    const std::uint8_t *data, std::size_t len, const types::placeholder_proof_batch_layout &layout) {
+
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using commitment_scheme_type = typename Proof::commitment_scheme_type;
+                    using FRI = typename commitment_scheme_type::basic_fri;
+
+                    const types::batch_info_type batch_info = layout.batch_info();
+                    const std::uint8_t *iter = data;
+                    std::size_t remaining_len = len;
+                    Proof proof;
+
+                    typename types::merkle_node_value_fixed<TTypeBase, typename commitment_scheme_type::commitment_type>::type
+                        filled_commitment;
+                    for (const auto batch : layout.commitment_batches) {
+                        read_placeholder_proof_batch_field(filled_commitment, iter, remaining_len);
+                        proof.commitments[batch] =
+                            types::make_merkle_node_value_fixed<typename commitment_scheme_type::commitment_type, Endianness>(
+                                filled_commitment);
+                    }
+                    types::field_element<TTypeBase, typename Proof::field_type::value_type> filled_value;
+                    read_placeholder_proof_batch_field(filled_value, iter, remaining_len);
+                    proof.eval_proof.challenge = filled_value.value();
+
+                    auto &z = proof.eval_proof.eval_proof.z;
+                    std::size_t poly = 0;
+                    for (const auto &batch : layout.batches) {
+                        z.set_batch_size(batch.first, batch.second);
+                        for (std::size_t j = 0; j < batch.second; j++, poly++) {
+                            z.set_poly_points_number(batch.first, j, layout.points[poly]);
+                            for (std::size_t k = 0; k < layout.points[poly]; k++) {
+                                read_placeholder_proof_batch_field(filled_value, iter, remaining_len);
+                                z.set(batch.first, j, k, filled_value.value());
+                            }
+                        }
+                    }
+
+                    auto &fri_proof = proof.eval_proof.eval_proof.fri_proof;
+                    typename types::merkle_node_value_fixed<TTypeBase, typename FRI::commitment_type>::type filled_root;
+                    for (std::size_t r = 0; r < layout.step_list.size(); r++) {
+                        read_placeholder_proof_batch_field(filled_root, iter, remaining_len);
+                        fri_proof.fri_roots.push_back(
+                            types::make_merkle_node_value_fixed<typename FRI::commitment_type, Endianness>(filled_root));
+                    }
+                    fri_proof.query_proofs.resize(layout.lambda);
+                    for (auto &query_proof : fri_proof.query_proofs) {
+                        if (types::read_fri_query_initial_values<Endianness, FRI>(iter, remaining_len, batch_info,
+                                                                           layout.step_list, query_proof) !=
+                            nil::marshalling::status_type::success) {
+                            throw std::invalid_argument("Placeholder proof batch entry is truncated or malformed");
+                        }
+                    }
+                    for (auto &query_proof : fri_proof.query_proofs) {
+                        if (types::read_fri_query_round_values<Endianness, FRI>(iter, remaining_len, layout.step_list,
+                                                                         query_proof) !=
+                            nil::marshalling::status_type::success) {
+                            throw std::invalid_argument("Placeholder proof batch entry is truncated or malformed");
+                        }
+                    }
+                    types::merkle_proof_compact<TTypeBase, typename FRI::merkle_proof_type> filled_merkle_proof;
+                    for (auto &query_proof : fri_proof.query_proofs) {
+                        for (const auto &it : batch_info) {
+                            read_placeholder_proof_batch_field(filled_merkle_proof, iter, remaining_len);
+                            query_proof.initial_proof[it.first].p =
+                                types::make_merkle_proof_compact<typename FRI::merkle_proof_type, Endianness>(filled_merkle_proof);
+                        }
+                    }
+                    for (auto &query_proof : fri_proof.query_proofs) {
+                        for (auto &round_proof : query_proof.round_proofs) {
+                            read_placeholder_proof_batch_field(filled_merkle_proof, iter, remaining_len);
+                            round_proof.p =
+                                types::make_merkle_proof_compact<typename FRI::merkle_proof_type, Endianness>(filled_merkle_proof);
+                        }
+                    }
+                    types::fri_math_polynomial<TTypeBase, typename FRI::polynomial_type> filled_final_polynomial;
+                    read_placeholder_proof_batch_field(filled_final_polynomial, iter, remaining_len);
+                    fri_proof.final_polynomial =
+                        types::make_fri_math_polynomial<Endianness, typename FRI::polynomial_type>(filled_final_polynomial);
+                    nil::marshalling::types::integral<TTypeBase, typename FRI::grinding_type::output_type>
+                        filled_proof_of_work;
+                    read_placeholder_proof_batch_field(filled_proof_of_work, iter, remaining_len);
+                    fri_proof.proof_of_work = filled_proof_of_work.value();
+
+                    if (remaining_len != 0) {
+                        throw std::invalid_argument("Placeholder proof batch entry has trailing bytes");
+                    }
+                    return proof;
+                }
+            }    // namespace detail
+
+            namespace types {
+                // Packs proofs of one circuit, encoding them on threads_amount threads (0 means hardware
+                // concurrency). Throws std::invalid_argument if the proofs do not share one layout.
+                template<typename Endianness, typename Proof, typename CommitmentParamsType>
+                typename std::enable_if<nil::crypto3::zk::is_lpc<typename Proof::commitment_scheme_type>,
+                                        placeholder_proof_batch<nil::marshalling::field_type<Endianness>, Proof>>::type
+                    fill_placeholder_proof_batch(const std::vector<Proof> &proofs,
+                                                 const CommitmentParamsType &commitment_params,
+                                                 std::size_t threads_amount = 1) {
+
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using octet_marshalling_type = nil::marshalling::types::integral<TTypeBase, std::uint8_t>;
+                    using offset_marshalling_type = nil::marshalling::types::integral<TTypeBase, std::uint64_t>;
+
+                    if (proofs.empty()) {
+                        throw std::invalid_argument("Placeholder proof batch needs at least one proof");
+                    }
+                    const placeholder_proof_batch_layout layout =
+                        make_placeholder_proof_batch_layout(proofs[0], commitment_params);
+                    if (layout.step_list.empty()) {
+                        throw std::invalid_argument("FRI step_list is empty");
+                    }
+
+                    std::vector<std::vector<std::uint8_t>> entries(proofs.size());
+                    detail::parallel_for(0, proofs.size(), threads_amount, [&](std::size_t first, std::size_t last) {
+                        for (std::size_t i = first; i < last; i++) {
+                            if (make_placeholder_proof_batch_layout(proofs[i], commitment_params) != layout) {
+                                throw std::invalid_argument("Placeholder proofs in a batch must share one layout");
+                            }
+                            detail::vector_field_writer writer(entries[i]);
+                            if (detail::write_placeholder_proof_batch_entry<Endianness>(proofs[i], layout, writer) !=
+                                nil::marshalling::status_type::success) {
+                                throw std::invalid_argument("Placeholder proof batch entry cannot be written");
+                            }
+                        }
+                    });
+
+                    std::vector<std::uint8_t> filled_layout_bytes;
+                    auto out = std::back_inserter(filled_layout_bytes);
+                    detail::write_varint(layout.commitment_batches.size(), out);
+                    for (const auto batch : layout.commitment_batches) {
+                        detail::write_varint(batch, out);
+                    }
+                    detail::write_varint(layout.batches.size(), out);
+                    for (const auto &batch : layout.batches) {
+                        detail::write_varint(batch.first, out);
+                        detail::write_varint(batch.second, out);
+                    }
+                    for (const auto points : layout.points) {
+                        detail::write_varint(points, out);
+                    }
+                    detail::write_varint(layout.lambda, out);
+                    detail::write_varint(layout.step_list.size(), out);
+                    for (const auto step : layout.step_list) {
+                        detail::write_varint(step, out);
+                    }
+
+                    placeholder_proof_batch<TTypeBase, Proof> filled;
+                    auto &filled_layout = std::get<0>(filled.value()).value();
+                    filled_layout.reserve(filled_layout_bytes.size());
+                    for (const std::uint8_t byte : filled_layout_bytes) {
+                        filled_layout.push_back(octet_marshalling_type(byte));
+                    }
+                    auto &filled_offsets = std::get<1>(filled.value()).value();
+                    auto &filled_payload = std::get<2>(filled.value()).value();
+                    filled_offsets.reserve(entries.size() + 1);
+                    std::size_t payload_size = 0;
+                    for (const auto &entry : entries) {
+                        filled_offsets.push_back(offset_marshalling_type(payload_size));
+                        payload_size += entry.size();
+                    }
+                    filled_offsets.push_back(offset_marshalling_type(payload_size));
+                    filled_payload.reserve(payload_size);
+                    for (const auto &entry : entries) {
+                        for (const std::uint8_t byte : entry) {
+                            filled_payload.push_back(octet_marshalling_type(byte));
+                        }
+                    }
+                    return filled;
+                }
+
+                // Decodes the layout and offset table of a placeholder_proof_batch once; proofs are then
+                // decoded individually, concurrently if wanted. Throws std::invalid_argument on malformed data.
+                template<typename Endianness, typename Proof>
+                class placeholder_proof_batch_reader {
+                public:
+                    using filled_type = placeholder_proof_batch<nil::marshalling::field_type<Endianness>, Proof>;
+
+                    explicit placeholder_proof_batch_reader(const filled_type &filled) {
+                        const auto &filled_layout = std::get<0>(filled.value()).value();
+                        std::vector<std::uint8_t> layout_bytes;
+                        layout_bytes.reserve(filled_layout.size());
+                        for (const auto &byte : filled_layout) {
+                            layout_bytes.push_back(byte.value());
+                        }
+                        auto iter = layout_bytes.cbegin();
+                        auto read_layout = [&iter, &layout_bytes]() {
+                            std::uint64_t value = 0;
+                            if (!detail::read_varint(iter, layout_bytes.cend(), value)) {
+                                throw std::invalid_argument("Invalid varint in placeholder proof batch layout");
+                            }
+                            return value;
+                        };
+                        // Every entry takes at least one byte, which bounds the sizes before allocating.
+                        auto read_layout_size = [&read_layout, &layout_bytes]() {
+                            std::uint64_t value = read_layout();
+                            if (value > layout_bytes.size()) {
+                                throw std::invalid_argument("Placeholder proof batch layout is too short");
+                            }
+                            return value;
+                        };
+
+                        _layout.commitment_batches.resize(read_layout_size());
+                        for (auto &batch : _layout.commitment_batches) {
+                            batch = read_layout();
+                        }
+                        _layout.batches.resize(read_layout_size());
+                        std::size_t polys_amount = 0;
+                        for (auto &batch : _layout.batches) {
+                            batch.first = read_layout();
+                            batch.second = read_layout_size();
+                            polys_amount += batch.second;
+                        }
+                        if (polys_amount > layout_bytes.size()) {
+                            throw std::invalid_argument("Placeholder proof batch layout is too short");
+                        }
+                        _layout.points.resize(polys_amount);
+                        for (auto &points : _layout.points) {
+                            points = read_layout();
+                        }
+                        _layout.lambda = read_layout();
+                        _layout.step_list.resize(read_layout_size());
+                        for (auto &step : _layout.step_list) {
+                            const std::uint64_t value = read_layout();
+                            if (value == 0 || value >= std::numeric_limits<std::uint32_t>::digits) {
+                                throw std::invalid_argument("Invalid FRI step in placeholder proof batch layout");
+                            }
+                            step = static_cast<std::uint8_t>(value);
+                        }
+                        if (iter != layout_bytes.cend() || _layout.step_list.empty()) {
+                            throw std::invalid_argument("Malformed placeholder proof batch layout");
+                        }
+
+                        const auto &filled_payload = std::get<2>(filled.value()).value();
+                        _payload.reserve(filled_payload.size());
+                        for (const auto &byte : filled_payload) {
+                            _payload.push_back(byte.value());
+                        }
+                        const auto &filled_offsets = std::get<1>(filled.value()).value();
+                        if (filled_offsets.empty() || filled_offsets.front().value() != 0 ||
+                            filled_offsets.back().value() != _payload.size()) {
+                            throw std::invalid_argument("Malformed placeholder proof batch offsets");
+                        }
+                        _offsets.reserve(filled_offsets.size());
+                        for (const auto &offset : filled_offsets) {
+                            if (!_offsets.empty() && offset.value() < _offsets.back()) {
+                                throw std::invalid_argument("Malformed placeholder proof batch offsets");
+                            }
+                            _offsets.push_back(offset.value());
+                        }
+
+                        // Every z value and every FRI query takes at least one byte of an entry, which bounds
+                        // the layout sizes before any entry is decoded.
+                        std::size_t max_entry_size = 0;
+                        for (std::size_t i = 1; i < _offsets.size(); i++) {
+                            max_entry_size = std::max<std::size_t>(max_entry_size, _offsets[i] - _offsets[i - 1]);
+                        }
+                        std::size_t points_amount = 0;
+                        for (const auto points : _layout.points) {
+                            if (points > max_entry_size - points_amount) {
+                                throw std::invalid_argument("Placeholder proof batch layout does not fit the payload");
+                            }
+                            points_amount += points;
+                        }
+                        if (_layout.lambda > max_entry_size) {
+                            throw std::invalid_argument("Placeholder proof batch layout does not fit the payload");
+                        }
+                    }
+
+                    std::size_t size() const {
+                        return _offsets.size() - 1;
+                    }
+
+                    const placeholder_proof_batch_layout &layout() const {
+                        return _layout;
+                    }
+
+                    // Decodes proof i. Safe to call concurrently.
+                    Proof proof(std::size_t i) const {
+                        if (i >= size()) {
+                            throw std::out_of_range("Placeholder proof batch index out of range");
+                        }
+                        return detail::read_placeholder_proof_batch_entry<Endianness, Proof>(
+                            _payload.data() + _offsets[i], _offsets[i + 1] - _offsets[i], _layout);
+                    }
+
+                    // Decodes all proofs on threads_amount threads, 0 meaning hardware concurrency.
+                    std::vector<Proof> proofs(std::size_t threads_amount = 1) const {
+                        std::vector<Proof> result(size());
+                        detail::parallel_for(0, size(), threads_amount, [this, &result](std::size_t first, std::size_t last) {
+                            for (std::size_t i = first; i < last; i++) {
+                                result[i] = proof(i);
+                            }
+                        });
+                        return result;
+                    }
+
+                private:
+                    placeholder_proof_batch_layout _layout;
+                    std::vector<std::size_t> _offsets;
+                    std::vector<std::uint8_t> _payload;
+                };
+
+                template<typename Endianness, typename Proof>
+                std::vector<Proof> make_placeholder_proof_batch(
+                    const placeholder_proof_batch<nil::marshalling::field_type<Endianness>, Proof> &filled,
+                    std::size_t threads_amount = 1) {
+                    return placeholder_proof_batch_reader<Endianness, Proof>(filled).proofs(threads_amount);
+                }
+            }    // namespace types
+        }        // namespace marshalling
+    }            // namespace crypto3
+}    // namespace nil
+#endif    // CRYPTO3_MARSHALLING_PLACEHOLDER_PROOF_BATCH_HPP
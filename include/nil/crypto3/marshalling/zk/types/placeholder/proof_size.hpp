@@ -0,0 +1,99 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Nil Foundation <info@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+
+#ifndef CRYPTO3_MARSHALLING_PLACEHOLDER_PROOF_SIZE_HPP
+#define CRYPTO3_MARSHALLING_PLACEHOLDER_PROOF_SIZE_HPP
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+#include <nil/marshalling/field_type.hpp>
+
+#include <nil/crypto3/zk/commitments/type_traits.hpp>
+
+#include <nil/crypto3/marshalling/zk/types/commitments/fri.hpp>
+#include <nil/crypto3/marshalling/zk/types/commitments/lpc.hpp>
+#include <nil/crypto3/marshalling/zk/types/placeholder/proof.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace marshalling {
+            namespace types {
+                // Serialized size in bytes of each section of a placeholder proof. Length prefixes are
+                // counted with the section they precede, so the sections add up to the whole proof.
+                struct placeholder_proof_size_breakdown {
+                    std::size_t commitments = 0;
+                    std::size_t challenge = 0;
+                    std::size_t z_values = 0;
+                    std::size_t fri_roots = 0;
+                    std::size_t fri_step_list = 0;
+                    std::size_t initial_values = 0;
+                    std::size_t round_values = 0;
+                    std::size_t initial_merkle_proofs = 0;
+                    std::size_t round_merkle_proofs = 0;
+                    std::size_t final_polynomial = 0;
+                    std::size_t proof_of_work = 0;
+
+                    std::size_t total() const {
+                        return commitments + challenge + z_values + fri_roots + fri_step_list + initial_values +
+                               round_values + initial_merkle_proofs + round_merkle_proofs + final_polynomial +
+                               proof_of_work;
+                    }
+                };
+
+                // FOR LPC only because of the FRI sections
+                template<typename Endianness, typename Proof>
+                typename std::enable_if<nil::crypto3::zk::is_lpc<typename Proof::commitment_scheme_type>,
+                                        placeholder_proof_size_breakdown>::type
+                    make_placeholder_proof_size_breakdown(
+                        const placeholder_proof<nil::marshalling::field_type<Endianness>, Proof> &filled_proof) {
+
+                    placeholder_proof_size_breakdown result;
+                    result.commitments = std::get<0>(filled_proof.value()).length();
+
+                    const auto &filled_evaluation_proof = std::get<1>(filled_proof.value());
+                    result.challenge = std::get<0>(filled_evaluation_proof.value()).length();
+
+                    const auto &filled_eval_proof = std::get<1>(filled_evaluation_proof.value());
+                    result.z_values = std::get<0>(filled_eval_proof.value()).length();
+
+                    const auto &filled_fri_proof = std::get<1>(filled_eval_proof.value());
+                    result.fri_roots = std::get<0>(filled_fri_proof.value()).length();
+                    result.fri_step_list = std::get<1>(filled_fri_proof.value()).length();
+                    result.initial_values = std::get<2>(filled_fri_proof.value()).length();
+                    result.round_values = std::get<3>(filled_fri_proof.value()).length();
+                    result.initial_merkle_proofs = std::get<4>(filled_fri_proof.value()).length();
+                    result.round_merkle_proofs = std::get<5>(filled_fri_proof.value()).length();
+                    result.final_polynomial = std::get<6>(filled_fri_proof.value()).length();
+                    result.proof_of_work = std::get<7>(filled_fri_proof.value()).length();
+
+                    return result;
+                }
+            }    // namespace types
+        }        // namespace marshalling
+    }            // namespace crypto3
+}    // namespace nil
+#endif    // CRYPTO3_MARSHALLING_PLACEHOLDER_PROOF_SIZE_HPP
@@ -25,7 +25,16 @@
 #ifndef CRYPTO3_MARSHALLING_ZK_PLONK_ASSIGNMENT_TABLE_HPP
 #define CRYPTO3_MARSHALLING_ZK_PLONK_ASSIGNMENT_TABLE_HPP
 
+#include <algorithm>
 #include <type_traits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/iterator/transform_iterator.hpp>
 
 #include <nil/crypto3/zk/snark/arithmetization/plonk/constraint_system.hpp>
 #include <nil/crypto3/zk/snark/arithmetization/plonk/table_description.hpp>
@@ -37,6 +46,9 @@
 #include <nil/marshalling/status_type.hpp>
 #include <nil/marshalling/options.hpp>
 #include <nil/crypto3/marshalling/algebra/types/field_element.hpp>
+#include <nil/crypto3/marshalling/zk/detail/field_writer.hpp>
+#include <nil/crypto3/marshalling/zk/detail/hash_field_writer.hpp>
+#include <nil/crypto3/marshalling/zk/detail/parallel_for.hpp>
 
 namespace nil {
     namespace crypto3 {
@@ -103,8 +115,12 @@ namespace nil {
                         nil::marshalling::option::sequence_size_field_prefix<
                             nil::marshalling::types::integral<TTypeBase, std::size_t>>>;
 
+                    std::size_t elements_amount = 0;
+                    for (std::size_t column_number = 0; column_number < columns.size(); column_number++) {
+                        elements_amount += std::max(columns[column_number].size(), size);
+                    }
                     field_element_vector_type result;
-                    result.value().reserve(size * columns.size());
+                    result.value().reserve(elements_amount);
                     for (std::size_t column_number = 0; column_number < columns.size(); column_number++) {
                         for (std::size_t i = 0; i < columns[column_number].size(); i++) {
                             result.value().push_back(field_element_type(columns[column_number][i]));
@@ -127,14 +143,20 @@ namespace nil {
                     const std::size_t columns_amount,
                     const std::size_t rows_amount) {
 
-                    std::vector<std::vector<FieldValueType>> result(
-                        columns_amount, std::vector<FieldValueType>(rows_amount));
+                    using field_element_type = field_element<nil::marshalling::field_type<Endianness>, FieldValueType>;
+
                     BOOST_ASSERT(field_elem_vector.value().size() == columns_amount * rows_amount);
-                    std::size_t cur = 0;
-                    for (std::size_t i = 0; i < columns_amount; i++) {
-                        for (std::size_t j = 0; j < rows_amount; j++, cur++) {
-                            result[i][j] = field_elem_vector.value()[cur].value();
-                        }
+                    auto get_value = [](const field_element_type &cell) -> const FieldValueType & {
+                        return cell.value();
+                    };
+                    // One allocation per column, each column is constructed straight from its cells.
+                    std::vector<std::vector<FieldValueType>> result;
+                    result.reserve(columns_amount);
+                    auto cells = field_elem_vector.value().cbegin();
+                    for (std::size_t i = 0; i < columns_amount; i++, cells += rows_amount) {
+                        result.emplace_back(
+                            boost::make_transform_iterator(cells, get_value),
+                            boost::make_transform_iterator(cells + rows_amount, get_value));
                     }
                     return result;
                 }
@@ -177,6 +199,182 @@ namespace nil {
                         )
                     )));
                 }
+                // Writes columns in the fill_field_element_vector_from_columns_with_padding wire format
+                // cell by cell, without building the intermediate field_element vector.
+                template<typename FieldValueType, typename Endianness, typename FieldWriter>
+                nil::marshalling::status_type write_field_element_columns_with_padding(
+                    const std::vector<std::vector<FieldValueType>> &columns,
+                    const std::size_t size,
+                    const FieldValueType &padding,
+                    FieldWriter &writer) {
+
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using field_element_type = field_element<TTypeBase, FieldValueType>;
+
+                    std::size_t elements_amount = 0;
+                    for (std::size_t column_number = 0; column_number < columns.size(); column_number++) {
+                        elements_amount += std::max(columns[column_number].size(), size);
+                    }
+                    nil::marshalling::status_type status =
+                        writer.write(nil::marshalling::types::integral<TTypeBase, std::size_t>(elements_amount));
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+
+                    const field_element_type filled_padding(padding);
+                    for (std::size_t column_number = 0; column_number < columns.size(); column_number++) {
+                        for (std::size_t i = 0; i < columns[column_number].size(); i++) {
+                            status = writer.write(field_element_type(columns[column_number][i]));
+                            if (status != nil::marshalling::status_type::success) {
+                                return status;
+                            }
+                        }
+                        for (std::size_t i = columns[column_number].size(); i < size; i++) {
+                            status = writer.write(filled_padding);
+                            if (status != nil::marshalling::status_type::success) {
+                                return status;
+                            }
+                        }
+                    }
+                    return status;
+                }
+
+                template<typename FieldValueType, typename Endianness>
+                std::size_t field_element_columns_with_padding_length(
+                    const std::vector<std::vector<FieldValueType>> &columns,
+                    const std::size_t size) {
+
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+
+                    std::size_t elements_amount = 0;
+                    for (std::size_t column_number = 0; column_number < columns.size(); column_number++) {
+                        elements_amount += std::max(columns[column_number].size(), size);
+                    }
+                    return nil::marshalling::types::integral<TTypeBase, std::size_t>().length() +
+                           elements_amount * field_element<TTypeBase, FieldValueType>().length();
+                }
+
+                // Byte length of fill_assignment_table(usable_rows, assignments), computed without filling it.
+                template<typename Endianness, typename PlonkTable>
+                std::size_t assignment_table_length(const PlonkTable &assignments) {
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using value_type = typename PlonkTable::field_type::value_type;
+
+                    return 6 * nil::marshalling::types::integral<TTypeBase, std::size_t>().length() +
+                        field_element_columns_with_padding_length<value_type, Endianness>(
+                            assignments.witnesses(), assignments.rows_amount()) +
+                        field_element_columns_with_padding_length<value_type, Endianness>(
+                            assignments.public_inputs(), assignments.rows_amount()) +
+                        field_element_columns_with_padding_length<value_type, Endianness>(
+                            assignments.constants(), assignments.rows_amount()) +
+                        field_element_columns_with_padding_length<value_type, Endianness>(
+                            assignments.selectors(), assignments.rows_amount());
+                }
+
+                // Serializes the table in the plonk_assignment_table wire format straight from its columns.
+                // Produces the same bytes as fill_assignment_table(...).write(...), but never holds
+                // more than one cell's wrapper at a time.
+                template<typename Endianness, typename PlonkTable, typename FieldWriter>
+                nil::marshalling::status_type write_assignment_table(
+                    std::size_t usable_rows,
+                    const PlonkTable &assignments,
+                    FieldWriter &writer
+                ){
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using value_type = typename PlonkTable::field_type::value_type;
+                    using size_marshalling_type = nil::marshalling::types::integral<TTypeBase, std::size_t>;
+
+                    const std::size_t header[] = {
+                        assignments.witnesses_amount(),
+                        assignments.public_inputs_amount(),
+                        assignments.constants_amount(),
+                        assignments.selectors_amount(),
+                        usable_rows,
+                        assignments.rows_amount()
+                    };
+                    nil::marshalling::status_type status = nil::marshalling::status_type::success;
+                    for (const std::size_t value : header) {
+                        status = writer.write(size_marshalling_type(value));
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                    }
+
+                    const value_type padding = 0u;
+                    for (const auto *columns : {
+                             &assignments.witnesses(), &assignments.public_inputs(),
+                             &assignments.constants(), &assignments.selectors()}) {
+                        status = write_field_element_columns_with_padding<value_type, Endianness>(
+                            *columns, assignments.rows_amount(), padding, writer);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                    }
+                    return status;
+                }
+
+                template<typename Endianness, typename PlonkTable, typename TIter>
+                nil::marshalling::status_type write_assignment_table(
+                    std::size_t usable_rows,
+                    const PlonkTable &assignments,
+                    TIter &iter,
+                    std::size_t len
+                ){
+                    if (len < assignment_table_length<Endianness>(assignments)) {
+                        return nil::marshalling::status_type::buffer_overflow;
+                    }
+                    detail::iterator_field_writer<TIter> writer(iter, len);
+                    return write_assignment_table<Endianness>(usable_rows, assignments, writer);
+                }
+
+                template<typename Endianness, typename PlonkTable>
+                nil::marshalling::status_type write_assignment_table(
+                    std::size_t usable_rows,
+                    const PlonkTable &assignments,
+                    std::ostream &os
+                ){
+                    detail::ostream_field_writer writer(os);
+                    nil::marshalling::status_type status =
+                        write_assignment_table<Endianness>(usable_rows, assignments, writer);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    return writer.flush();
+                }
+
+                // Hash digest of the plonk_assignment_table serialization of the table. The bytes are hashed
+                // as they are produced and never stored.
+                template<typename Endianness, typename Hash, typename PlonkTable>
+                typename Hash::digest_type assignment_table_digest(
+                    std::size_t usable_rows,
+                    const PlonkTable &assignments
+                ){
+                    detail::hash_field_writer<Hash> writer;
+                    nil::marshalling::status_type status =
+                        write_assignment_table<Endianness>(usable_rows, assignments, writer);
+                    BOOST_ASSERT(status == nil::marshalling::status_type::success);
+                    return writer.digest();
+                }
+
+                // Serializes the table to os and computes the digest of the written bytes in the same pass.
+                template<typename Endianness, typename Hash, typename PlonkTable>
+                nil::marshalling::status_type write_assignment_table_with_digest(
+                    std::size_t usable_rows,
+                    const PlonkTable &assignments,
+                    std::ostream &os,
+                    typename Hash::digest_type &digest
+                ){
+                    detail::hash_ostream_field_writer<Hash> writer(os);
+                    nil::marshalling::status_type status =
+                        write_assignment_table<Endianness>(usable_rows, assignments, writer);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    status = writer.flush();
+                    digest = writer.digest();
+                    return status;
+                }
+
                 template<typename Endianness, typename PlonkTable>
                 std::pair<zk::snark::plonk_table_description<typename PlonkTable::field_type>, PlonkTable> make_assignment_table(
                         const plonk_assignment_table<nil::marshalling::field_type<Endianness>, PlonkTable> &filled_assignments){
@@ -224,8 +422,96 @@ namespace nil {
                         );
 
                     return std::make_pair(desc, PlonkTable(
-                        typename PlonkTable::private_table_type(witnesses),
-                        typename PlonkTable::public_table_type(public_inputs, constants, selectors)
+                        typename PlonkTable::private_table_type(std::move(witnesses)),
+                        typename PlonkTable::public_table_type(
+                            std::move(public_inputs), std::move(constants), std::move(selectors))
+                    ));
+                }
+
+                // Same as make_assignment_table(filled_assignments), decoding on threads_amount threads
+                // (0 means std::thread::hardware_concurrency()). Columns of all four kinds are split
+                // between threads; when there are fewer columns than threads, row ranges are split instead.
+                template<typename Endianness, typename PlonkTable>
+                std::pair<zk::snark::plonk_table_description<typename PlonkTable::field_type>, PlonkTable> make_assignment_table(
+                        const plonk_assignment_table<nil::marshalling::field_type<Endianness>, PlonkTable> &filled_assignments,
+                        std::size_t threads_amount){
+
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using value_type = typename PlonkTable::field_type::value_type;
+                    using field_element_type = field_element<TTypeBase, value_type>;
+                    using column_type = std::vector<value_type>;
+
+                    zk::snark::plonk_table_description<typename PlonkTable::field_type> desc(
+                        std::get<0>(filled_assignments.value()).value(),
+                        std::get<1>(filled_assignments.value()).value(),
+                        std::get<2>(filled_assignments.value()).value(),
+                        std::get<3>(filled_assignments.value()).value(),
+                        std::get<4>(filled_assignments.value()).value(),
+                        std::get<5>(filled_assignments.value()).value()
+                    );
+
+                    if ( desc.usable_rows_amount >= desc.rows_amount )
+                        throw std::invalid_argument(
+                            "Rows amount should be greater than usable rows amount. Rows amount = " +
+                            std::to_string(desc.rows_amount) +
+                            ", usable rows amount = " + std::to_string(desc.usable_rows_amount));
+
+                    const std::size_t rows_amount = desc.rows_amount;
+                    std::vector<column_type> witnesses(desc.witness_columns);
+                    std::vector<column_type> public_inputs(desc.public_input_columns);
+                    std::vector<column_type> constants(desc.constant_columns);
+                    std::vector<column_type> selectors(desc.selector_columns);
+
+                    // Source of every output column: first cell in the flat field element vector.
+                    using cells_iterator = decltype(std::get<6>(filled_assignments.value()).value().cbegin());
+                    std::vector<std::pair<cells_iterator, column_type *>> jobs;
+                    jobs.reserve(witnesses.size() + public_inputs.size() + constants.size() + selectors.size());
+                    auto add_jobs = [&jobs, rows_amount](const auto &filled_columns, std::vector<column_type> &columns) {
+                        if (filled_columns.value().size() != columns.size() * rows_amount) {
+                            throw std::invalid_argument("Assignment table column data size mismatch");
+                        }
+                        for (std::size_t i = 0; i < columns.size(); i++) {
+                            jobs.emplace_back(filled_columns.value().cbegin() + i * rows_amount, &columns[i]);
+                        }
+                    };
+                    add_jobs(std::get<6>(filled_assignments.value()), witnesses);
+                    add_jobs(std::get<7>(filled_assignments.value()), public_inputs);
+                    add_jobs(std::get<8>(filled_assignments.value()), constants);
+                    add_jobs(std::get<9>(filled_assignments.value()), selectors);
+
+                    if (threads_amount == 0) {
+                        threads_amount = detail::default_threads_amount();
+                    }
+                    auto get_value = [](const field_element_type &cell) -> const value_type & {
+                        return cell.value();
+                    };
+                    if (jobs.size() >= threads_amount) {
+                        // Each column is constructed directly from its cells with a single allocation.
+                        detail::parallel_for(0, jobs.size(), threads_amount, [&jobs, &get_value, rows_amount](
+                                std::size_t first, std::size_t last) {
+                            for (std::size_t i = first; i < last; i++) {
+                                jobs[i].second->assign(
+                                    boost::make_transform_iterator(jobs[i].first, get_value),
+                                    boost::make_transform_iterator(jobs[i].first + rows_amount, get_value));
+                            }
+                        });
+                    } else {
+                        for (auto &job : jobs) {
+                            job.second->resize(rows_amount);
+                        }
+                        detail::parallel_for(0, jobs.size() * rows_amount, threads_amount, [&jobs, rows_amount](
+                                std::size_t first, std::size_t last) {
+                            for (std::size_t cur = first; cur < last; cur++) {
+                                const auto &job = jobs[cur / rows_amount];
+                                (*job.second)[cur % rows_amount] = job.first[cur % rows_amount].value();
+                            }
+                        });
+                    }
+
+                    return std::make_pair(desc, PlonkTable(
+                        typename PlonkTable::private_table_type(std::move(witnesses)),
+                        typename PlonkTable::public_table_type(
+                            std::move(public_inputs), std::move(constants), std::move(selectors))
                     ));
                 }
             } //namespace types
@@ -0,0 +1,395 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Nil Foundation <info@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_MARSHALLING_ZK_PLONK_ASSIGNMENT_TABLE_CHUNKED_HPP
+#define CRYPTO3_MARSHALLING_ZK_PLONK_ASSIGNMENT_TABLE_CHUNKED_HPP
+
+#include <algorithm>
+#include <initializer_list>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <nil/crypto3/zk/snark/arithmetization/plonk/table_description.hpp>
+#include <nil/crypto3/zk/snark/arithmetization/plonk/assignment.hpp>
+
+#include <nil/marshalling/types/bundle.hpp>
+#include <nil/marshalling/types/array_list.hpp>
+#include <nil/marshalling/types/integral.hpp>
+#include <nil/marshalling/status_type.hpp>
+#include <nil/marshalling/options.hpp>
+#include <nil/crypto3/marshalling/algebra/types/field_element.hpp>
+#include <nil/crypto3/marshalling/zk/detail/field_writer.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace marshalling {
+            namespace types {
+                // Chunked assignment table: a header followed by ceil(rows_amount / chunk_rows) chunks.
+                // Each chunk holds the same block of rows for every column, so the table can be written
+                // and read back one chunk at a time with memory bounded by the chunk size.
+                template<typename TTypeBase>
+                using plonk_assignment_table_chunked_header = nil::marshalling::types::bundle<
+                    TTypeBase, std::tuple<
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // witness_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // public_input_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // constant_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // selector_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // usable_rows
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // rows_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>  // chunk_rows
+                    >
+                >;
+
+                template<typename Endianness, typename PlonkTable, typename FieldWriter>
+                nil::marshalling::status_type write_assignment_table_chunk(
+                    const PlonkTable &assignments,
+                    std::size_t first_row,
+                    std::size_t rows,
+                    FieldWriter &writer
+                ){
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using value_type = typename PlonkTable::field_type::value_type;
+                    using size_marshalling_type = nil::marshalling::types::integral<TTypeBase, std::size_t>;
+                    using field_element_type = field_element<TTypeBase, value_type>;
+
+                    const std::size_t columns_amount = assignments.witnesses_amount() + assignments.public_inputs_amount() +
+                        assignments.constants_amount() + assignments.selectors_amount();
+
+                    nil::marshalling::status_type status = writer.write(size_marshalling_type(first_row));
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    status = writer.write(size_marshalling_type(rows));
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    status = writer.write(size_marshalling_type(rows * columns_amount));
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+
+                    const field_element_type filled_padding(value_type(0u));
+                    for (const auto *columns : {
+                             &assignments.witnesses(), &assignments.public_inputs(),
+                             &assignments.constants(), &assignments.selectors()}) {
+                        for (const auto &column : *columns) {
+                            const std::size_t stored_rows = std::min(column.size(), first_row + rows);
+                            for (std::size_t i = first_row; i < stored_rows; i++) {
+                                status = writer.write(field_element_type(column[i]));
+                                if (status != nil::marshalling::status_type::success) {
+                                    return status;
+                                }
+                            }
+                            for (std::size_t i = std::max(stored_rows, first_row); i < first_row + rows; i++) {
+                                status = writer.write(filled_padding);
+                                if (status != nil::marshalling::status_type::success) {
+                                    return status;
+                                }
+                            }
+                        }
+                    }
+                    return status;
+                }
+
+                // Streams the table as a header followed by row-block chunks of chunk_rows rows each.
+                // Only one buffer of the writer is held in memory at a time.
+                template<typename Endianness, typename PlonkTable>
+                nil::marshalling::status_type write_assignment_table_chunked(
+                    std::size_t usable_rows,
+                    const PlonkTable &assignments,
+                    std::size_t chunk_rows,
+                    std::ostream &os
+                ){
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using size_marshalling_type = nil::marshalling::types::integral<TTypeBase, std::size_t>;
+
+                    if (chunk_rows == 0) {
+                        return nil::marshalling::status_type::invalid_msg_data;
+                    }
+
+                    detail::ostream_field_writer writer(os);
+                    nil::marshalling::status_type status = writer.write(plonk_assignment_table_chunked_header<TTypeBase>(
+                        std::make_tuple(
+                            size_marshalling_type(assignments.witnesses_amount()),
+                            size_marshalling_type(assignments.public_inputs_amount()),
+                            size_marshalling_type(assignments.constants_amount()),
+                            size_marshalling_type(assignments.selectors_amount()),
+                            size_marshalling_type(usable_rows),
+                            size_marshalling_type(assignments.rows_amount()),
+                            size_marshalling_type(chunk_rows)
+                        )));
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+
+                    for (std::size_t first_row = 0; first_row < assignments.rows_amount(); first_row += chunk_rows) {
+                        status = write_assignment_table_chunk<Endianness>(
+                            assignments, first_row, std::min(chunk_rows, assignments.rows_amount() - first_row), writer);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                    }
+                    return writer.flush();
+                }
+
+                // Reads a chunked assignment table from a stream one chunk at a time.
+                template<typename Endianness, typename PlonkTable>
+                class plonk_assignment_table_chunk_reader {
+                public:
+                    using field_type = typename PlonkTable::field_type;
+                    using value_type = typename field_type::value_type;
+                    using column_type = std::vector<value_type>;
+                    using table_description_type = zk::snark::plonk_table_description<field_type>;
+
+                    struct chunk_type {
+                        std::size_t first_row = 0;
+                        std::size_t rows_amount = 0;
+                        std::vector<column_type> witnesses;
+                        std::vector<column_type> public_inputs;
+                        std::vector<column_type> constants;
+                        std::vector<column_type> selectors;
+                    };
+
+                    explicit plonk_assignment_table_chunk_reader(std::istream &is) :
+                        _is(is), _desc(0, 0, 0, 0), _chunk_rows(0), _next_row(0), _columns_amount(0) {
+                    }
+
+                    nil::marshalling::status_type read_header() {
+                        plonk_assignment_table_chunked_header<TTypeBase> header;
+                        nil::marshalling::status_type status = read_bytes(header.length());
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        auto iter = _buffer.cbegin();
+                        status = header.read(iter, header.length());
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+
+                        _desc = table_description_type(
+                            std::get<0>(header.value()).value(),
+                            std::get<1>(header.value()).value(),
+                            std::get<2>(header.value()).value(),
+                            std::get<3>(header.value()).value(),
+                            std::get<4>(header.value()).value(),
+                            std::get<5>(header.value()).value()
+                        );
+                        _chunk_rows = std::get<6>(header.value()).value();
+                        _next_row = 0;
+                        // The header is untrusted: sum the column counts without wrapping around.
+                        _columns_amount = 0;
+                        for (const std::size_t columns : {_desc.witness_columns, _desc.public_input_columns,
+                                                          _desc.constant_columns, _desc.selector_columns}) {
+                            if (columns > std::numeric_limits<std::size_t>::max() - _columns_amount) {
+                                _chunk_rows = 0;
+                                return nil::marshalling::status_type::invalid_msg_data;
+                            }
+                            _columns_amount += columns;
+                        }
+                        if (_chunk_rows == 0) {
+                            return nil::marshalling::status_type::invalid_msg_data;
+                        }
+                        return status;
+                    }
+
+                    const table_description_type &table_description() const {
+                        return _desc;
+                    }
+
+                    std::size_t chunk_rows() const {
+                        return _chunk_rows;
+                    }
+
+                    // First row of the next chunk to be read.
+                    std::size_t next_row() const {
+                        return _next_row;
+                    }
+
+                    bool has_next_chunk() const {
+                        return _chunk_rows != 0 && _next_row < _desc.rows_amount;
+                    }
+
+                    // Reads the next chunk into chunk, reusing its column storage. The header and the chunk
+                    // prefix are untrusted, so cells are read in blocks of at most read_block_cells as the
+                    // stream delivers them and columns only grow with decoded cells.
+                    nil::marshalling::status_type read_chunk(chunk_type &chunk) {
+                        using size_marshalling_type = nil::marshalling::types::integral<TTypeBase, std::size_t>;
+                        using field_element_type = field_element<TTypeBase, value_type>;
+
+                        if (!has_next_chunk()) {
+                            return nil::marshalling::status_type::not_enough_data;
+                        }
+
+                        size_marshalling_type first_row, rows, cells_amount;
+                        const std::size_t prefix_length = 3 * first_row.length();
+                        nil::marshalling::status_type status = read_bytes(prefix_length);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+                        auto iter = _buffer.cbegin();
+                        first_row.read(iter, first_row.length());
+                        rows.read(iter, rows.length());
+                        cells_amount.read(iter, cells_amount.length());
+
+                        // Check cells_amount == rows * columns by division, the product may overflow.
+                        const bool cells_amount_matches = _columns_amount == 0 ?
+                            cells_amount.value() == 0 :
+                            cells_amount.value() % _columns_amount == 0 &&
+                                cells_amount.value() / _columns_amount == rows.value();
+                        if (first_row.value() != _next_row ||
+                            rows.value() != std::min(_chunk_rows, _desc.rows_amount - _next_row) ||
+                            !cells_amount_matches) {
+                            return nil::marshalling::status_type::invalid_msg_data;
+                        }
+
+                        field_element_type cell;
+                        std::size_t remaining_cells = cells_amount.value();
+                        std::size_t block_cells = 0;
+                        std::size_t block_position = 0;
+                        auto read_cell = [&](value_type &value) {
+                            if (block_position == block_cells) {
+                                block_cells = std::min(remaining_cells, read_block_cells);
+                                block_position = 0;
+                                remaining_cells -= block_cells;
+                                status = read_bytes(block_cells * cell.length());
+                                if (status != nil::marshalling::status_type::success) {
+                                    return status;
+                                }
+                            }
+                            auto cell_iter = _buffer.cbegin() + block_position * cell.length();
+                            status = cell.read(cell_iter, cell.length());
+                            block_position++;
+                            value = cell.value();
+                            return status;
+                        };
+
+                        chunk.first_row = first_row.value();
+                        chunk.rows_amount = rows.value();
+                        for (auto group : {
+                                 std::make_pair(&chunk.witnesses, _desc.witness_columns),
+                                 std::make_pair(&chunk.public_inputs, _desc.public_input_columns),
+                                 std::make_pair(&chunk.constants, _desc.constant_columns),
+                                 std::make_pair(&chunk.selectors, _desc.selector_columns)}) {
+                            for (std::size_t i = 0; i < group.second; i++) {
+                                if (i == group.first->size()) {
+                                    group.first->emplace_back();
+                                }
+                                auto &column = (*group.first)[i];
+                                column.clear();
+                                for (std::size_t j = 0; j < chunk.rows_amount; j++) {
+                                    value_type value;
+                                    if (read_cell(value) != nil::marshalling::status_type::success) {
+                                        return status;
+                                    }
+                                    column.push_back(value);
+                                }
+                            }
+                            group.first->resize(group.second);
+                        }
+                        _next_row += chunk.rows_amount;
+                        return status;
+                    }
+
+                private:
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+
+                    constexpr static const std::size_t read_block_cells = 4096;
+
+                    nil::marshalling::status_type read_bytes(std::size_t len) {
+                        _buffer.resize(len);
+                        _is.read(reinterpret_cast<char *>(_buffer.data()), len);
+                        if (static_cast<std::size_t>(_is.gcount()) != len) {
+                            return nil::marshalling::status_type::not_enough_data;
+                        }
+                        return nil::marshalling::status_type::success;
+                    }
+
+                    std::istream &_is;
+                    table_description_type _desc;
+                    std::size_t _chunk_rows;
+                    std::size_t _next_row;
+                    std::size_t _columns_amount;
+                    std::vector<std::uint8_t> _buffer;
+                };
+
+                // Loads a whole chunked assignment table. The serialized data is never held in memory
+                // as a whole, only the resulting table and one chunk.
+                template<typename Endianness, typename PlonkTable>
+                std::pair<zk::snark::plonk_table_description<typename PlonkTable::field_type>, PlonkTable>
+                make_assignment_table_chunked(std::istream &is) {
+                    using reader_type = plonk_assignment_table_chunk_reader<Endianness, PlonkTable>;
+                    using column_type = typename reader_type::column_type;
+
+                    reader_type reader(is);
+                    if (reader.read_header() != nil::marshalling::status_type::success) {
+                        throw std::invalid_argument("Invalid chunked assignment table header");
+                    }
+                    auto desc = reader.table_description();
+                    if ( desc.usable_rows_amount >= desc.rows_amount )
+                        throw std::invalid_argument(
+                            "Rows amount should be greater than usable rows amount. Rows amount = " +
+                            std::to_string(desc.rows_amount) +
+                            ", usable rows amount = " + std::to_string(desc.usable_rows_amount));
+
+                    // Columns and their rows grow with each validated chunk; the header's amounts are not
+                    // trusted for allocation.
+                    std::vector<column_type> witnesses;
+                    std::vector<column_type> public_inputs;
+                    std::vector<column_type> constants;
+                    std::vector<column_type> selectors;
+                    typename reader_type::chunk_type chunk;
+                    while (reader.has_next_chunk()) {
+                        if (reader.read_chunk(chunk) != nil::marshalling::status_type::success) {
+                            throw std::invalid_argument(
+                                "Invalid chunked assignment table chunk at row " + std::to_string(reader.next_row()));
+                        }
+                        for (auto group : {
+                                 std::make_pair(&witnesses, &chunk.witnesses),
+                                 std::make_pair(&public_inputs, &chunk.public_inputs),
+                                 std::make_pair(&constants, &chunk.constants),
+                                 std::make_pair(&selectors, &chunk.selectors)}) {
+                            group.first->resize(group.second->size());
+                            for (std::size_t i = 0; i < group.first->size(); i++) {
+                                (*group.first)[i].insert((*group.first)[i].end(),
+                                    (*group.second)[i].begin(), (*group.second)[i].end());
+                            }
+                        }
+                    }
+
+                    return std::make_pair(desc, PlonkTable(
+                        typename PlonkTable::private_table_type(std::move(witnesses)),
+                        typename PlonkTable::public_table_type(
+                            std::move(public_inputs), std::move(constants), std::move(selectors))
+                    ));
+                }
+            } //namespace types
+        } // namespace marshalling
+    } // namespace crypto3
+} // namespace nil
+
+#endif    // CRYPTO3_MARSHALLING_ZK_PLONK_ASSIGNMENT_TABLE_CHUNKED_HPP
@@ -0,0 +1,365 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Nil Foundation <info@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_MARSHALLING_ZK_PLONK_ASSIGNMENT_TABLE_COLUMNAR_HPP
+#define CRYPTO3_MARSHALLING_ZK_PLONK_ASSIGNMENT_TABLE_COLUMNAR_HPP
+
+#include <algorithm>
+#include <initializer_list>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <nil/crypto3/zk/snark/arithmetization/plonk/table_description.hpp>
+#include <nil/crypto3/zk/snark/arithmetization/plonk/assignment.hpp>
+
+#include <nil/marshalling/types/bundle.hpp>
+#include <nil/marshalling/types/array_list.hpp>
+#include <nil/marshalling/types/integral.hpp>
+#include <nil/marshalling/status_type.hpp>
+#include <nil/marshalling/options.hpp>
+#include <nil/crypto3/marshalling/algebra/types/field_element.hpp>
+#include <nil/crypto3/marshalling/zk/detail/field_writer.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace marshalling {
+            namespace types {
+                // Columnar assignment table layout:
+                //   header | column offset table | padding | column 0 | padding | column 1 | ...
+                // Every cell is a fixed-width field_element encoding, every column starts at an offset
+                // aligned to plonk_assignment_table_columnar_alignment, so a mapped file can be read
+                // in place without parsing the cells.
+                constexpr static const std::size_t plonk_assignment_table_columnar_alignment = 64;
+
+                template<typename TTypeBase>
+                using plonk_assignment_table_columnar_header = nil::marshalling::types::bundle<
+                    TTypeBase, std::tuple<
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // witness_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // public_input_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // constant_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // selector_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // usable_rows
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // rows_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // bytes per cell
+                        // Byte offset of every column from the beginning of the layout
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            nil::marshalling::types::integral<TTypeBase, std::uint64_t>,
+                            nil::marshalling::option::sequence_size_field_prefix<
+                                nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >
+                    >
+                >;
+
+                // Writes the columnar layout. Cells are encoded exactly as field_element<> encodes them.
+                template<typename Endianness, typename PlonkTable>
+                nil::marshalling::status_type write_assignment_table_columnar(
+                    std::size_t usable_rows,
+                    const PlonkTable &assignments,
+                    std::ostream &os
+                ){
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using value_type = typename PlonkTable::field_type::value_type;
+                    using size_marshalling_type = nil::marshalling::types::integral<TTypeBase, std::size_t>;
+                    using offset_marshalling_type = nil::marshalling::types::integral<TTypeBase, std::uint64_t>;
+                    using header_type = plonk_assignment_table_columnar_header<TTypeBase>;
+                    using field_element_type = field_element<TTypeBase, value_type>;
+
+                    const std::size_t rows_amount = assignments.rows_amount();
+                    const std::size_t element_size = field_element_type().length();
+                    const std::size_t columns_amount = assignments.witnesses_amount() +
+                        assignments.public_inputs_amount() + assignments.constants_amount() +
+                        assignments.selectors_amount();
+                    auto align = [](std::size_t offset) {
+                        return (offset + plonk_assignment_table_columnar_alignment - 1) /
+                            plonk_assignment_table_columnar_alignment * plonk_assignment_table_columnar_alignment;
+                    };
+
+                    header_type header(std::make_tuple(
+                        size_marshalling_type(assignments.witnesses_amount()),
+                        size_marshalling_type(assignments.public_inputs_amount()),
+                        size_marshalling_type(assignments.constants_amount()),
+                        size_marshalling_type(assignments.selectors_amount()),
+                        size_marshalling_type(usable_rows),
+                        size_marshalling_type(rows_amount),
+                        size_marshalling_type(element_size),
+                        typename std::tuple_element<7, typename header_type::value_type>::type()
+                    ));
+                    auto &offsets = std::get<7>(header.value()).value();
+                    offsets.resize(columns_amount);
+                    std::size_t offset = align(header.length());
+                    for (std::size_t i = 0; i < columns_amount; i++) {
+                        offsets[i] = offset_marshalling_type(offset);
+                        offset = align(offset + rows_amount * element_size);
+                    }
+
+                    detail::ostream_field_writer writer(os);
+                    nil::marshalling::status_type status = writer.write(header);
+                    if (status != nil::marshalling::status_type::success) {
+                        return status;
+                    }
+                    std::size_t written = header.length();
+                    const nil::marshalling::types::integral<TTypeBase, std::uint8_t> zero_byte(0);
+                    const field_element_type filled_padding(value_type(0u));
+
+                    std::size_t column_index = 0;
+                    for (const auto *columns : {
+                             &assignments.witnesses(), &assignments.public_inputs(),
+                             &assignments.constants(), &assignments.selectors()}) {
+                        for (const auto &column : *columns) {
+                            for (; written < offsets[column_index].value(); written++) {
+                                status = writer.write(zero_byte);
+                                if (status != nil::marshalling::status_type::success) {
+                                    return status;
+                                }
+                            }
+                            for (std::size_t i = 0; i < rows_amount; i++) {
+                                status = writer.write(i < column.size() ? field_element_type(column[i]) : filled_padding);
+                                if (status != nil::marshalling::status_type::success) {
+                                    return status;
+                                }
+                            }
+                            written += rows_amount * element_size;
+                            column_index++;
+                        }
+                    }
+                    return writer.flush();
+                }
+
+                // Read-only view of one column in the columnar layout. Holds no copy of the cells:
+                // raw bytes are exposed as they are, values are converted on access.
+                template<typename Endianness, typename FieldValueType>
+                class field_element_column_view {
+                public:
+                    using value_type = FieldValueType;
+
+                    field_element_column_view() : _data(nullptr), _rows(0), _element_size(0) {
+                    }
+
+                    field_element_column_view(const std::uint8_t *data, std::size_t rows, std::size_t element_size) :
+                        _data(data), _rows(rows), _element_size(element_size) {
+                    }
+
+                    const std::uint8_t *data() const {
+                        return _data;
+                    }
+
+                    std::size_t size() const {
+                        return _rows;
+                    }
+
+                    std::size_t size_bytes() const {
+                        return _rows * _element_size;
+                    }
+
+                    std::size_t element_size() const {
+                        return _element_size;
+                    }
+
+                    value_type operator[](std::size_t row) const {
+                        BOOST_ASSERT(row < _rows);
+                        field_element<nil::marshalling::field_type<Endianness>, value_type> cell;
+                        const std::uint8_t *iter = _data + row * _element_size;
+                        cell.read(iter, _element_size);
+                        return cell.value();
+                    }
+
+                    std::vector<value_type> to_vector() const {
+                        std::vector<value_type> result;
+                        result.reserve(_rows);
+                        for (std::size_t row = 0; row < _rows; row++) {
+                            result.push_back((*this)[row]);
+                        }
+                        return result;
+                    }
+
+                private:
+                    const std::uint8_t *_data;
+                    std::size_t _rows;
+                    std::size_t _element_size;
+                };
+
+                // Validates a columnar layout placed in memory and hands out per-column views into it.
+                // The memory must outlive the view.
+                template<typename Endianness, typename PlonkTable>
+                class plonk_assignment_table_columnar_view {
+                public:
+                    using field_type = typename PlonkTable::field_type;
+                    using value_type = typename field_type::value_type;
+                    using column_view_type = field_element_column_view<Endianness, value_type>;
+                    using table_description_type = zk::snark::plonk_table_description<field_type>;
+
+                    plonk_assignment_table_columnar_view() : _desc(0, 0, 0, 0) {
+                    }
+
+                    nil::marshalling::status_type parse(const std::uint8_t *data, std::size_t len) {
+                        using TTypeBase = nil::marshalling::field_type<Endianness>;
+                        using field_element_type = field_element<TTypeBase, value_type>;
+
+                        plonk_assignment_table_columnar_header<TTypeBase> header;
+                        const std::uint8_t *iter = data;
+                        nil::marshalling::status_type status = header.read(iter, len);
+                        if (status != nil::marshalling::status_type::success) {
+                            return status;
+                        }
+
+                        // The view keeps its previous table until the whole header is validated.
+                        table_description_type desc(
+                            std::get<0>(header.value()).value(),
+                            std::get<1>(header.value()).value(),
+                            std::get<2>(header.value()).value(),
+                            std::get<3>(header.value()).value(),
+                            std::get<4>(header.value()).value(),
+                            std::get<5>(header.value()).value()
+                        );
+                        const std::size_t element_size = std::get<6>(header.value()).value();
+                        const auto &offsets = std::get<7>(header.value()).value();
+                        if (desc.usable_rows_amount >= desc.rows_amount) {
+                            return nil::marshalling::status_type::invalid_msg_data;
+                        }
+                        // The header is untrusted: sum the column counts without wrapping around.
+                        std::size_t columns_amount = 0;
+                        for (const std::size_t columns : {desc.witness_columns, desc.public_input_columns,
+                                                          desc.constant_columns, desc.selector_columns}) {
+                            if (columns > std::numeric_limits<std::size_t>::max() - columns_amount) {
+                                return nil::marshalling::status_type::invalid_msg_data;
+                            }
+                            columns_amount += columns;
+                        }
+                        if (element_size != field_element_type().length() || offsets.size() != columns_amount) {
+                            return nil::marshalling::status_type::invalid_msg_data;
+                        }
+
+                        std::vector<column_view_type> columns;
+                        columns.reserve(columns_amount);
+                        for (const auto &offset : offsets) {
+                            // Divide rather than multiply, rows_amount * element_size may overflow.
+                            if (offset.value() < header.length() || offset.value() > len ||
+                                desc.rows_amount > (len - offset.value()) / element_size) {
+                                return nil::marshalling::status_type::not_enough_data;
+                            }
+                            columns.emplace_back(data + offset.value(), desc.rows_amount, element_size);
+                        }
+                        _desc = desc;
+                        _columns = std::move(columns);
+                        return status;
+                    }
+
+                    const table_description_type &table_description() const {
+                        return _desc;
+                    }
+
+                    const column_view_type &witness(std::size_t index) const {
+                        BOOST_ASSERT(index < _desc.witness_columns);
+                        return _columns[index];
+                    }
+
+                    const column_view_type &public_input(std::size_t index) const {
+                        BOOST_ASSERT(index < _desc.public_input_columns);
+                        return _columns[_desc.witness_columns + index];
+                    }
+
+                    const column_view_type &constant(std::size_t index) const {
+                        BOOST_ASSERT(index < _desc.constant_columns);
+                        return _columns[_desc.witness_columns + _desc.public_input_columns + index];
+                    }
+
+                    const column_view_type &selector(std::size_t index) const {
+                        BOOST_ASSERT(index < _desc.selector_columns);
+                        return _columns[_desc.witness_columns + _desc.public_input_columns +
+                                        _desc.constant_columns + index];
+                    }
+
+                    // Converts every cell and builds the table.
+                    std::pair<table_description_type, PlonkTable> make_assignment_table() const {
+                        using column_type = std::vector<value_type>;
+
+                        std::vector<column_type> witnesses, public_inputs, constants, selectors;
+                        witnesses.reserve(_desc.witness_columns);
+                        public_inputs.reserve(_desc.public_input_columns);
+                        constants.reserve(_desc.constant_columns);
+                        selectors.reserve(_desc.selector_columns);
+                        for (std::size_t i = 0; i < _desc.witness_columns; i++) {
+                            witnesses.emplace_back(witness(i).to_vector());
+                        }
+                        for (std::size_t i = 0; i < _desc.public_input_columns; i++) {
+                            public_inputs.emplace_back(public_input(i).to_vector());
+                        }
+                        for (std::size_t i = 0; i < _desc.constant_columns; i++) {
+                            constants.emplace_back(constant(i).to_vector());
+                        }
+                        for (std::size_t i = 0; i < _desc.selector_columns; i++) {
+                            selectors.emplace_back(selector(i).to_vector());
+                        }
+                        return std::make_pair(_desc, PlonkTable(
+                            typename PlonkTable::private_table_type(std::move(witnesses)),
+                            typename PlonkTable::public_table_type(
+                                std::move(public_inputs), std::move(constants), std::move(selectors))
+                        ));
+                    }
+
+                private:
+                    table_description_type _desc;
+                    std::vector<column_view_type> _columns;
+                };
+
+                // Maps a columnar assignment table file read-only. The mapping is shared with every
+                // other process mapping the same file.
+                template<typename Endianness, typename PlonkTable>
+                class plonk_assignment_table_mapped_file {
+                public:
+                    using view_type = plonk_assignment_table_columnar_view<Endianness, PlonkTable>;
+
+                    explicit plonk_assignment_table_mapped_file(const std::string &path) :
+                        _file(path.c_str(), boost::interprocess::read_only),
+                        _region(_file, boost::interprocess::read_only) {
+                        if (_view.parse(static_cast<const std::uint8_t *>(_region.get_address()), _region.get_size()) !=
+                            nil::marshalling::status_type::success) {
+                            throw std::invalid_argument("Invalid columnar assignment table file " + path);
+                        }
+                    }
+
+                    const view_type &view() const {
+                        return _view;
+                    }
+
+                private:
+                    boost::interprocess::file_mapping _file;
+                    boost::interprocess::mapped_region _region;
+                    view_type _view;
+                };
+            } //namespace types
+        } // namespace marshalling
+    } // namespace crypto3
+} // namespace nil
+
+#endif    // CRYPTO3_MARSHALLING_ZK_PLONK_ASSIGNMENT_TABLE_COLUMNAR_HPP
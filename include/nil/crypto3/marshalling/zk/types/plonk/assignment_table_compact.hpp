@@ -0,0 +1,448 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Nil Foundation <info@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_MARSHALLING_ZK_PLONK_ASSIGNMENT_TABLE_COMPACT_HPP
+#define CRYPTO3_MARSHALLING_ZK_PLONK_ASSIGNMENT_TABLE_COMPACT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <nil/crypto3/zk/snark/arithmetization/plonk/table_description.hpp>
+#include <nil/crypto3/zk/snark/arithmetization/plonk/assignment.hpp>
+
+#include <nil/marshalling/types/bundle.hpp>
+#include <nil/marshalling/types/array_list.hpp>
+#include <nil/marshalling/types/integral.hpp>
+#include <nil/marshalling/status_type.hpp>
+#include <nil/marshalling/options.hpp>
+#include <nil/crypto3/marshalling/algebra/types/field_element.hpp>
+#include <nil/crypto3/marshalling/zk/detail/varint.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace marshalling {
+            namespace types {
+                // Encoding of a compact column payload.
+                enum class assignment_column_encoding : std::uint8_t {
+                    // full field elements
+                    field = 0,
+                    // 0/1 column packed 8 cells per byte, least significant bit first
+                    bits = 1,
+                    // small integers, fixed width little-endian
+                    u8 = 2,
+                    u16 = 3,
+                    u32 = 4,
+                    u64 = 5,
+                    // small integers, LEB128 varints
+                    varint = 6,
+                };
+
+                // Column without its zero padding: only cells up to the last non-zero one are stored,
+                // the reader pads the column back to rows_amount.
+                template<typename TTypeBase, typename FieldValueType>
+                using field_element_column_compact = nil::marshalling::types::bundle<
+                    TTypeBase, std::tuple<
+                        // assignment_column_encoding
+                        nil::marshalling::types::integral<TTypeBase, std::uint8_t>,
+                        // used rows
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>,
+                        // cells, for assignment_column_encoding::field
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            field_element<TTypeBase, FieldValueType>,
+                            nil::marshalling::option::sequence_size_field_prefix<
+                                nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >,
+                        // packed cells, for every other encoding
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            nil::marshalling::types::integral<TTypeBase, std::uint8_t>,
+                            nil::marshalling::option::sequence_size_field_prefix<
+                                nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >
+                    >
+                >;
+
+                template<typename TTypeBase, typename FieldValueType>
+                using field_element_columns_compact = nil::marshalling::types::array_list<
+                    TTypeBase,
+                    field_element_column_compact<TTypeBase, FieldValueType>,
+                    nil::marshalling::option::sequence_size_field_prefix<
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                >;
+
+                // Unpacks used_rows bits into result[0..used_rows). result must be zero-filled.
+                // Bits are first spread into a byte per cell in a branch-free loop the compiler can
+                // vectorise, only the non-zero cells are then assigned as field values.
+                template<typename FieldValueType>
+                void unpack_column_bits(
+                    const std::vector<std::uint8_t> &packed,
+                    std::size_t used_rows,
+                    std::vector<FieldValueType> &result) {
+
+                    std::vector<std::uint8_t> flags(packed.size() * 8);
+                    for (std::size_t i = 0; i < packed.size(); i++) {
+                        const std::uint8_t byte = packed[i];
+                        for (std::size_t bit = 0; bit < 8; bit++) {
+                            flags[8 * i + bit] = (byte >> bit) & 1u;
+                        }
+                    }
+                    const FieldValueType one = 1u;
+                    for (std::size_t j = 0; j < used_rows; j++) {
+                        if (flags[j]) {
+                            result[j] = one;
+                        }
+                    }
+                }
+
+                // Unpacks used_rows fixed-width little-endian integers into result[0..used_rows).
+                // result must be zero-filled.
+                template<typename FieldValueType>
+                void unpack_column_integers(
+                    const std::vector<std::uint8_t> &packed,
+                    std::size_t width,
+                    std::size_t used_rows,
+                    std::vector<FieldValueType> &result) {
+
+                    const std::uint8_t *cell = packed.data();
+                    for (std::size_t j = 0; j < used_rows; j++, cell += width) {
+                        std::uint64_t value = 0;
+                        for (std::size_t k = 0; k < width; k++) {
+                            value |= std::uint64_t(cell[k]) << (8 * k);
+                        }
+                        if (value != 0) {
+                            result[j] = FieldValueType(value);
+                        }
+                    }
+                }
+
+                template<typename TTypeBase, typename PlonkTable>
+                using plonk_assignment_table_compact = nil::marshalling::types::bundle<
+                    TTypeBase, std::tuple<
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // witness_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // public_input_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // constant_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // selector_amount
+
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // usable_rows
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // rows_amount
+                        // witnesses
+                        field_element_columns_compact<TTypeBase, typename PlonkTable::field_type::value_type>,
+                        // public_inputs
+                        field_element_columns_compact<TTypeBase, typename PlonkTable::field_type::value_type>,
+                        // constants
+                        field_element_columns_compact<TTypeBase, typename PlonkTable::field_type::value_type>,
+                        // selectors
+                        field_element_columns_compact<TTypeBase, typename PlonkTable::field_type::value_type>
+                    >
+                >;
+
+                // Picks the smallest encoding for every column: bits for 0/1 columns, fixed-width or
+                // varint integers for columns of values below 2^64, full field elements otherwise.
+                template<typename FieldType, typename Endianness>
+                field_element_columns_compact<nil::marshalling::field_type<Endianness>, typename FieldType::value_type>
+                    fill_field_element_columns_compact(
+                        const std::vector<std::vector<typename FieldType::value_type>> &columns) {
+
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using value_type = typename FieldType::value_type;
+                    using integral_type = typename FieldType::integral_type;
+                    using field_element_type = field_element<TTypeBase, value_type>;
+                    using octet_marshalling_type = nil::marshalling::types::integral<TTypeBase, std::uint8_t>;
+
+                    const value_type zero = 0u;
+                    const value_type one = 1u;
+                    auto fits_integer = [](const integral_type &integral) -> bool {
+                        if constexpr (FieldType::modulus_bits > 64) {
+                            return integral < (integral_type(1) << 64);
+                        } else {
+                            (void)integral;
+                            return true;
+                        }
+                    };
+                    field_element_columns_compact<TTypeBase, value_type> result;
+                    result.value().resize(columns.size());
+                    std::vector<std::uint64_t> integers;
+                    std::vector<std::uint8_t> packed;
+                    for (std::size_t column_number = 0; column_number < columns.size(); column_number++) {
+                        const auto &column = columns[column_number];
+                        std::size_t used_rows = column.size();
+                        while (used_rows > 0 && column[used_rows - 1] == zero) {
+                            used_rows--;
+                        }
+
+                        // Collect the column as machine integers while it stays below 2^64.
+                        integers.clear();
+                        std::uint64_t max_value = 0;
+                        for (std::size_t i = 0; i < used_rows; i++) {
+                            const integral_type integral = integral_type(column[i].data);
+                            if (!fits_integer(integral)) {
+                                break;
+                            }
+                            integers.push_back(static_cast<std::uint64_t>(integral));
+                            max_value = std::max(max_value, integers.back());
+                        }
+
+                        auto &filled_column = result.value()[column_number].value();
+                        std::get<1>(filled_column).value() = used_rows;
+                        if (integers.size() < used_rows) {
+                            std::get<0>(filled_column).value() =
+                                static_cast<std::uint8_t>(assignment_column_encoding::field);
+                            auto &cells = std::get<2>(filled_column).value();
+                            cells.reserve(used_rows);
+                            for (std::size_t i = 0; i < used_rows; i++) {
+                                cells.push_back(field_element_type(column[i]));
+                            }
+                            continue;
+                        }
+
+                        assignment_column_encoding encoding;
+                        packed.clear();
+                        if (max_value <= 1) {
+                            encoding = assignment_column_encoding::bits;
+                            packed.resize((used_rows + 7) / 8, 0);
+                            for (std::size_t i = 0; i < used_rows; i++) {
+                                packed[i / 8] |= std::uint8_t(integers[i] << (i % 8));
+                            }
+                        } else {
+                            std::size_t width = 8;
+                            encoding = assignment_column_encoding::u64;
+                            if (max_value <= 0xff) {
+                                width = 1;
+                                encoding = assignment_column_encoding::u8;
+                            } else if (max_value <= 0xffff) {
+                                width = 2;
+                                encoding = assignment_column_encoding::u16;
+                            } else if (max_value <= 0xffffffff) {
+                                width = 4;
+                                encoding = assignment_column_encoding::u32;
+                            }
+                            std::size_t varints_length = 0;
+                            for (const std::uint64_t value : integers) {
+                                varints_length += detail::varint_length(value);
+                            }
+                            if (varints_length < width * used_rows) {
+                                encoding = assignment_column_encoding::varint;
+                                packed.reserve(varints_length);
+                                for (const std::uint64_t value : integers) {
+                                    detail::write_varint(value, std::back_inserter(packed));
+                                }
+                            } else {
+                                packed.reserve(width * used_rows);
+                                for (const std::uint64_t value : integers) {
+                                    for (std::size_t k = 0; k < width; k++) {
+                                        packed.push_back(std::uint8_t(value >> (8 * k)));
+                                    }
+                                }
+                            }
+                        }
+                        std::get<0>(filled_column).value() = static_cast<std::uint8_t>(encoding);
+                        auto &filled_packed = std::get<3>(filled_column).value();
+                        filled_packed.reserve(packed.size());
+                        for (const std::uint8_t byte : packed) {
+                            filled_packed.push_back(octet_marshalling_type(byte));
+                        }
+                    }
+                    return result;
+                }
+
+                template<typename FieldValueType, typename Endianness>
+                std::vector<std::vector<FieldValueType>> make_field_element_columns_compact(
+                    const field_element_columns_compact<nil::marshalling::field_type<Endianness>, FieldValueType>
+                        &filled_columns,
+                    const std::size_t columns_amount,
+                    const std::size_t rows_amount) {
+
+                    if (filled_columns.value().size() != columns_amount) {
+                        throw std::invalid_argument(
+                            "Compact assignment table has " + std::to_string(filled_columns.value().size()) +
+                            " columns, expected " + std::to_string(columns_amount));
+                    }
+                    std::vector<std::vector<FieldValueType>> result(columns_amount);
+                    std::vector<std::uint8_t> packed;
+                    for (std::size_t i = 0; i < columns_amount; i++) {
+                        const auto &filled_column = filled_columns.value()[i].value();
+                        const std::size_t used_rows = std::get<1>(filled_column).value();
+                        if (used_rows > rows_amount) {
+                            throw std::invalid_argument(
+                                "Compact assignment table column is longer than rows_amount");
+                        }
+                        // Default-constructed field values are zero, which is the padding value.
+                        result[i].resize(rows_amount);
+
+                        const auto &filled_packed = std::get<3>(filled_column).value();
+                        packed.resize(filled_packed.size());
+                        for (std::size_t j = 0; j < filled_packed.size(); j++) {
+                            packed[j] = filled_packed[j].value();
+                        }
+
+                        const auto encoding = static_cast<assignment_column_encoding>(std::get<0>(filled_column).value());
+                        switch (encoding) {
+                            case assignment_column_encoding::field: {
+                                const auto &cells = std::get<2>(filled_column).value();
+                                if (cells.size() != used_rows) {
+                                    throw std::invalid_argument("Compact assignment table column size mismatch");
+                                }
+                                for (std::size_t j = 0; j < used_rows; j++) {
+                                    result[i][j] = cells[j].value();
+                                }
+                                break;
+                            }
+                            case assignment_column_encoding::bits: {
+                                if (packed.size() != (used_rows + 7) / 8) {
+                                    throw std::invalid_argument("Compact assignment table column size mismatch");
+                                }
+                                unpack_column_bits(packed, used_rows, result[i]);
+                                break;
+                            }
+                            case assignment_column_encoding::u8:
+                            case assignment_column_encoding::u16:
+                            case assignment_column_encoding::u32:
+                            case assignment_column_encoding::u64: {
+                                const std::size_t width = std::size_t(1) << (static_cast<std::size_t>(encoding) -
+                                    static_cast<std::size_t>(assignment_column_encoding::u8));
+                                if (packed.size() != width * used_rows) {
+                                    throw std::invalid_argument("Compact assignment table column size mismatch");
+                                }
+                                unpack_column_integers(packed, width, used_rows, result[i]);
+                                break;
+                            }
+                            case assignment_column_encoding::varint: {
+                                auto iter = packed.cbegin();
+                                for (std::size_t j = 0; j < used_rows; j++) {
+                                    std::uint64_t value;
+                                    if (!detail::read_varint(iter, packed.cend(), value)) {
+                                        throw std::invalid_argument("Invalid varint in compact assignment table column");
+                                    }
+                                    if (value != 0) {
+                                        result[i][j] = FieldValueType(value);
+                                    }
+                                }
+                                if (iter != packed.cend()) {
+                                    throw std::invalid_argument("Compact assignment table column size mismatch");
+                                }
+                                break;
+                            }
+                            default:
+                                throw std::invalid_argument(
+                                    "Unknown assignment column encoding " +
+                                    std::to_string(std::get<0>(filled_column).value()));
+                        }
+                    }
+                    return result;
+                }
+
+                template<typename Endianness, typename PlonkTable>
+                plonk_assignment_table_compact<nil::marshalling::field_type<Endianness>, PlonkTable>
+                    fill_assignment_table_compact(
+                        std::size_t usable_rows,
+                        const PlonkTable &assignments
+                ){
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using result_type = plonk_assignment_table_compact<TTypeBase, PlonkTable>;
+
+                    // The reader pads columns to rows_amount and rejects longer ones, so do not write them.
+                    for (const auto *columns : {&assignments.witnesses(), &assignments.public_inputs(),
+                                                &assignments.constants(), &assignments.selectors()}) {
+                        for (const auto &column : *columns) {
+                            if (column.size() > assignments.rows_amount()) {
+                                throw std::invalid_argument(
+                                    "Assignment table column is longer than rows_amount. Column size = " +
+                                    std::to_string(column.size()) +
+                                    ", rows amount = " + std::to_string(assignments.rows_amount()));
+                            }
+                        }
+                    }
+
+                    return result_type(std::make_tuple(
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>(assignments.witnesses_amount()),
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>(assignments.public_inputs_amount()),
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>(assignments.constants_amount()),
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>(assignments.selectors_amount()),
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>(usable_rows),
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>(assignments.rows_amount()),
+                        fill_field_element_columns_compact<typename PlonkTable::field_type, Endianness>(assignments.witnesses()),
+                        fill_field_element_columns_compact<typename PlonkTable::field_type, Endianness>(assignments.public_inputs()),
+                        fill_field_element_columns_compact<typename PlonkTable::field_type, Endianness>(assignments.constants()),
+                        fill_field_element_columns_compact<typename PlonkTable::field_type, Endianness>(assignments.selectors())
+                    ));
+                }
+
+                // Every column is padded back to rows_amount, so a short payload can describe a huge table.
+                // rows_amount must be a power of two not above max_rows_amount, which the caller picks for the
+                // tables it expects; it is checked before any column is allocated.
+                template<typename Endianness, typename PlonkTable>
+                std::pair<zk::snark::plonk_table_description<typename PlonkTable::field_type>, PlonkTable>
+                    make_assignment_table_compact(
+                        const plonk_assignment_table_compact<nil::marshalling::field_type<Endianness>, PlonkTable>
+                            &filled_assignments,
+                        std::size_t max_rows_amount
+                ){
+                    using value_type = typename PlonkTable::field_type::value_type;
+
+                    zk::snark::plonk_table_description<typename PlonkTable::field_type> desc(
+                        std::get<0>(filled_assignments.value()).value(),
+                        std::get<1>(filled_assignments.value()).value(),
+                        std::get<2>(filled_assignments.value()).value(),
+                        std::get<3>(filled_assignments.value()).value(),
+                        std::get<4>(filled_assignments.value()).value(),
+                        std::get<5>(filled_assignments.value()).value()
+                    );
+
+                    if ( desc.usable_rows_amount >= desc.rows_amount )
+                        throw std::invalid_argument(
+                            "Rows amount should be greater than usable rows amount. Rows amount = " +
+                            std::to_string(desc.rows_amount) +
+                            ", usable rows amount = " + std::to_string(desc.usable_rows_amount));
+                    if ( desc.rows_amount > max_rows_amount || (desc.rows_amount & (desc.rows_amount - 1)) != 0 )
+                        throw std::invalid_argument(
+                            "Rows amount should be a power of two not greater than " + std::to_string(max_rows_amount) +
+                            ". Rows amount = " + std::to_string(desc.rows_amount));
+
+                    auto witnesses = make_field_element_columns_compact<value_type, Endianness>(
+                        std::get<6>(filled_assignments.value()), desc.witness_columns, desc.rows_amount);
+                    auto public_inputs = make_field_element_columns_compact<value_type, Endianness>(
+                        std::get<7>(filled_assignments.value()), desc.public_input_columns, desc.rows_amount);
+                    auto constants = make_field_element_columns_compact<value_type, Endianness>(
+                        std::get<8>(filled_assignments.value()), desc.constant_columns, desc.rows_amount);
+                    auto selectors = make_field_element_columns_compact<value_type, Endianness>(
+                        std::get<9>(filled_assignments.value()), desc.selector_columns, desc.rows_amount);
+
+                    return std::make_pair(desc, PlonkTable(
+                        typename PlonkTable::private_table_type(std::move(witnesses)),
+                        typename PlonkTable::public_table_type(
+                            std::move(public_inputs), std::move(constants), std::move(selectors))
+                    ));
+                }
+            } //namespace types
+        } // namespace marshalling
+    } // namespace crypto3
+} // namespace nil
+
+#endif    // CRYPTO3_MARSHALLING_ZK_PLONK_ASSIGNMENT_TABLE_COMPACT_HPP
@@ -0,0 +1,326 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2024 Nil Foundation <info@nil.foundation>
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------//
+
+#ifndef CRYPTO3_MARSHALLING_ZK_PLONK_ASSIGNMENT_TABLE_SPLIT_HPP
+#define CRYPTO3_MARSHALLING_ZK_PLONK_ASSIGNMENT_TABLE_SPLIT_HPP
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <nil/crypto3/hash/sha2.hpp>
+
+#include <nil/crypto3/zk/snark/arithmetization/plonk/table_description.hpp>
+#include <nil/crypto3/zk/snark/arithmetization/plonk/assignment.hpp>
+
+#include <nil/marshalling/types/bundle.hpp>
+#include <nil/marshalling/types/array_list.hpp>
+#include <nil/marshalling/types/integral.hpp>
+#include <nil/marshalling/status_type.hpp>
+#include <nil/marshalling/options.hpp>
+#include <nil/crypto3/marshalling/algebra/types/field_element.hpp>
+#include <nil/crypto3/marshalling/zk/detail/hash_field_writer.hpp>
+#include <nil/crypto3/marshalling/zk/types/plonk/assignment_table.hpp>
+
+namespace nil {
+    namespace crypto3 {
+        namespace marshalling {
+            namespace types {
+                // Split assignment table: the fixed part (constants and selectors) is the same for every
+                // proof of a circuit and is stored once, identified by the digest of its serialized bytes.
+                // Every proof then only ships an instance part: witnesses, public inputs and that digest.
+                template<typename TTypeBase, typename PlonkTable>
+                using plonk_assignment_table_fixed_part = nil::marshalling::types::bundle<
+                    TTypeBase, std::tuple<
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // constant_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // selector_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // rows_amount
+                        // constants
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            field_element<TTypeBase, typename PlonkTable::field_type::value_type>,
+                            nil::marshalling::option::sequence_size_field_prefix<
+                                nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >,
+                        // selectors
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            field_element<TTypeBase, typename PlonkTable::field_type::value_type>,
+                            nil::marshalling::option::sequence_size_field_prefix<
+                                nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >
+                    >
+                >;
+
+                template<typename TTypeBase, typename PlonkTable>
+                using plonk_assignment_table_instance = nil::marshalling::types::bundle<
+                    TTypeBase, std::tuple<
+                        // digest of the fixed part
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            nil::marshalling::types::integral<TTypeBase, std::uint8_t>,
+                            nil::marshalling::option::sequence_size_field_prefix<
+                                nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >,
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // witness_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // public_input_amount
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // usable_rows
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>, // rows_amount
+                        // witnesses
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            field_element<TTypeBase, typename PlonkTable::field_type::value_type>,
+                            nil::marshalling::option::sequence_size_field_prefix<
+                                nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >,
+                        // public_inputs
+                        nil::marshalling::types::array_list<
+                            TTypeBase,
+                            field_element<TTypeBase, typename PlonkTable::field_type::value_type>,
+                            nil::marshalling::option::sequence_size_field_prefix<
+                                nil::marshalling::types::integral<TTypeBase, std::size_t>>
+                        >
+                    >
+                >;
+
+                template<typename Endianness, typename PlonkTable>
+                plonk_assignment_table_fixed_part<nil::marshalling::field_type<Endianness>, PlonkTable>
+                    fill_assignment_table_fixed_part(const PlonkTable &assignments) {
+
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using result_type = plonk_assignment_table_fixed_part<TTypeBase, PlonkTable>;
+                    using value_type = typename PlonkTable::field_type::value_type;
+
+                    return result_type(std::make_tuple(
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>(assignments.constants_amount()),
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>(assignments.selectors_amount()),
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>(assignments.rows_amount()),
+                        fill_field_element_vector_from_columns_with_padding<value_type, Endianness>(
+                            assignments.constants(),
+                            assignments.rows_amount(),
+                            0u
+                        ),
+                        fill_field_element_vector_from_columns_with_padding<value_type, Endianness>(
+                            assignments.selectors(),
+                            assignments.rows_amount(),
+                            0u
+                        )
+                    ));
+                }
+
+                // Digest identifying a fixed part: Hash over its serialized bytes, hashed field by field
+                // without materializing the serialization.
+                template<typename Endianness, typename PlonkTable, typename Hash = nil::crypto3::hashes::sha2<256>>
+                std::vector<std::uint8_t> assignment_table_fixed_part_digest(
+                    const plonk_assignment_table_fixed_part<nil::marshalling::field_type<Endianness>, PlonkTable>
+                        &filled_fixed_part) {
+
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+
+                    detail::hash_field_writer<Hash> writer;
+                    writer.write(std::get<0>(filled_fixed_part.value()));
+                    writer.write(std::get<1>(filled_fixed_part.value()));
+                    writer.write(std::get<2>(filled_fixed_part.value()));
+                    for (const auto *filled_columns : {
+                             &std::get<3>(filled_fixed_part.value()), &std::get<4>(filled_fixed_part.value())}) {
+                        writer.write(nil::marshalling::types::integral<TTypeBase, std::size_t>(
+                            filled_columns->value().size()));
+                        for (const auto &cell : filled_columns->value()) {
+                            writer.write(cell);
+                        }
+                    }
+                    typename Hash::digest_type digest = writer.digest();
+                    return std::vector<std::uint8_t>(digest.begin(), digest.end());
+                }
+
+                template<typename Endianness, typename PlonkTable>
+                plonk_assignment_table_instance<nil::marshalling::field_type<Endianness>, PlonkTable>
+                    fill_assignment_table_instance(
+                        std::size_t usable_rows,
+                        const PlonkTable &assignments,
+                        const std::vector<std::uint8_t> &fixed_part_digest
+                ){
+                    using TTypeBase = nil::marshalling::field_type<Endianness>;
+                    using result_type = plonk_assignment_table_instance<TTypeBase, PlonkTable>;
+                    using value_type = typename PlonkTable::field_type::value_type;
+                    using octet_marshalling_type = nil::marshalling::types::integral<TTypeBase, std::uint8_t>;
+
+                    typename std::tuple_element<0, typename result_type::value_type>::type filled_digest;
+                    filled_digest.value().reserve(fixed_part_digest.size());
+                    for (const std::uint8_t byte : fixed_part_digest) {
+                        filled_digest.value().push_back(octet_marshalling_type(byte));
+                    }
+
+                    return result_type(std::make_tuple(
+                        filled_digest,
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>(assignments.witnesses_amount()),
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>(assignments.public_inputs_amount()),
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>(usable_rows),
+                        nil::marshalling::types::integral<TTypeBase, std::size_t>(assignments.rows_amount()),
+                        fill_field_element_vector_from_columns_with_padding<value_type, Endianness>(
+                            assignments.witnesses(),
+                            assignments.rows_amount(),
+                            0u
+                        ),
+                        fill_field_element_vector_from_columns_with_padding<value_type, Endianness>(
+                            assignments.public_inputs(),
+                            assignments.rows_amount(),
+                            0u
+                        )
+                    ));
+                }
+
+                // In-process store of decoded fixed parts, keyed by digest. Safe to share between threads.
+                template<typename Endianness, typename PlonkTable, typename Hash = nil::crypto3::hashes::sha2<256>>
+                class plonk_assignment_table_fixed_part_cache {
+                public:
+                    using value_type = typename PlonkTable::field_type::value_type;
+                    using digest_type = std::vector<std::uint8_t>;
+                    using filled_fixed_part_type =
+                        plonk_assignment_table_fixed_part<nil::marshalling::field_type<Endianness>, PlonkTable>;
+
+                    struct fixed_part_type {
+                        std::size_t rows_amount;
+                        std::vector<std::vector<value_type>> constants;
+                        std::vector<std::vector<value_type>> selectors;
+                    };
+
+                    // Decodes the fixed part unless it is already stored, returns its digest.
+                    digest_type insert(const filled_fixed_part_type &filled_fixed_part) {
+                        digest_type digest =
+                            assignment_table_fixed_part_digest<Endianness, PlonkTable, Hash>(filled_fixed_part);
+                        if (find(digest)) {
+                            return digest;
+                        }
+
+                        const std::size_t rows_amount = std::get<2>(filled_fixed_part.value()).value();
+                        auto fixed_part = std::make_shared<fixed_part_type>();
+                        fixed_part->rows_amount = rows_amount;
+                        fixed_part->constants = make_field_element_columns_vector<value_type, Endianness>(
+                            std::get<3>(filled_fixed_part.value()),
+                            std::get<0>(filled_fixed_part.value()).value(),
+                            rows_amount
+                        );
+                        fixed_part->selectors = make_field_element_columns_vector<value_type, Endianness>(
+                            std::get<4>(filled_fixed_part.value()),
+                            std::get<1>(filled_fixed_part.value()).value(),
+                            rows_amount
+                        );
+
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _fixed_parts.emplace(digest, std::move(fixed_part));
+                        return digest;
+                    }
+
+                    // Returns nullptr if no fixed part with this digest was inserted.
+                    std::shared_ptr<const fixed_part_type> find(const digest_type &digest) const {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        auto it = _fixed_parts.find(digest);
+                        return it == _fixed_parts.end() ? nullptr : it->second;
+                    }
+
+                    std::size_t size() const {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        return _fixed_parts.size();
+                    }
+
+                    void clear() {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _fixed_parts.clear();
+                    }
+
+                private:
+                    mutable std::mutex _mutex;
+                    std::map<digest_type, std::shared_ptr<const fixed_part_type>> _fixed_parts;
+                };
+
+                // Rebuilds the full table from an instance part, taking its fixed part from the cache.
+                template<typename Endianness, typename PlonkTable, typename Hash>
+                std::pair<zk::snark::plonk_table_description<typename PlonkTable::field_type>, PlonkTable>
+                    make_assignment_table_instance(
+                        const plonk_assignment_table_instance<nil::marshalling::field_type<Endianness>, PlonkTable>
+                            &filled_instance,
+                        const plonk_assignment_table_fixed_part_cache<Endianness, PlonkTable, Hash> &cache
+                ){
+                    using value_type = typename PlonkTable::field_type::value_type;
+
+                    std::vector<std::uint8_t> digest;
+                    digest.reserve(std::get<0>(filled_instance.value()).value().size());
+                    for (const auto &byte : std::get<0>(filled_instance.value()).value()) {
+                        digest.push_back(byte.value());
+                    }
+                    auto fixed_part = cache.find(digest);
+                    if (!fixed_part) {
+                        throw std::invalid_argument("Unknown assignment table fixed part digest");
+                    }
+
+                    zk::snark::plonk_table_description<typename PlonkTable::field_type> desc(
+                        std::get<1>(filled_instance.value()).value(),
+                        std::get<2>(filled_instance.value()).value(),
+                        fixed_part->constants.size(),
+                        fixed_part->selectors.size(),
+                        std::get<3>(filled_instance.value()).value(),
+                        std::get<4>(filled_instance.value()).value()
+                    );
+                    if (desc.rows_amount != fixed_part->rows_amount) {
+                        throw std::invalid_argument(
+                            "Assignment table instance has " + std::to_string(desc.rows_amount) +
+                            " rows, its fixed part has " + std::to_string(fixed_part->rows_amount));
+                    }
+                    if ( desc.usable_rows_amount >= desc.rows_amount )
+                        throw std::invalid_argument(
+                            "Rows amount should be greater than usable rows amount. Rows amount = " +
+                            std::to_string(desc.rows_amount) +
+                            ", usable rows amount = " + std::to_string(desc.usable_rows_amount));
+
+                    std::vector<std::vector<value_type>> witnesses =
+                        make_field_element_columns_vector<value_type, Endianness>(
+                            std::get<5>(filled_instance.value()),
+                            desc.witness_columns,
+                            desc.rows_amount
+                        );
+                    std::vector<std::vector<value_type>> public_inputs =
+                        make_field_element_columns_vector<value_type, Endianness>(
+                            std::get<6>(filled_instance.value()),
+                            desc.public_input_columns,
+                            desc.rows_amount
+                        );
+
+                    return std::make_pair(desc, PlonkTable(
+                        typename PlonkTable::private_table_type(std::move(witnesses)),
+                        typename PlonkTable::public_table_type(
+                            std::move(public_inputs), fixed_part->constants, fixed_part->selectors)
+                    ));
+                }
+            } //namespace types
+        } // namespace marshalling
+    } // namespace crypto3
+} // namespace nil
+
+#endif    // CRYPTO3_MARSHALLING_ZK_PLONK_ASSIGNMENT_TABLE_SPLIT_HPP
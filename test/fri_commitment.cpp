@@ -31,8 +31,10 @@
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/uniform_int.hpp>
+#include <functional>
 #include <iostream>
 #include <iomanip>
+#include <optional>
 #include <random>
 #include <regex>
 
@@ -69,6 +71,7 @@
 #include <nil/crypto3/zk/commitments/polynomial/fri.hpp>
 #include <nil/crypto3/zk/test_tools/random_test_initializer.hpp>
 #include <nil/crypto3/marshalling/zk/types/commitments/fri.hpp>
+#include <nil/crypto3/marshalling/zk/types/commitments/fri_proof_view.hpp>
 
 using namespace nil::crypto3;
 
@@ -314,6 +317,82 @@ void test_fri_proof(typename FRI::proof_type &proof, typename nil::crypto3::mars
     typename FRI::proof_type constructed_val_read = nil::crypto3::marshalling::types::make_fri_proof<Endianness, FRI>(
             test_val_read, batch_info);
     BOOST_CHECK(proof == constructed_val_read);
+    for (std::size_t threads_amount : {1, 4, 0}) {
+        BOOST_CHECK(proof == (nil::crypto3::marshalling::types::make_fri_proof<Endianness, FRI>(
+                test_val_read, batch_info, threads_amount)));
+    }
+    // A caller-supplied executor, here running the tasks in reverse on the calling thread
+    std::size_t executed_tasks = 0;
+    auto reverse_executor = [&executed_tasks](std::size_t tasks_amount, const std::function<void(std::size_t)> &task) {
+        for (std::size_t i = tasks_amount; i-- > 0;) {
+            task(i);
+            executed_tasks++;
+        }
+    };
+    BOOST_CHECK(proof == (nil::crypto3::marshalling::types::make_fri_proof<Endianness, FRI>(
+            test_val_read, batch_info, reverse_executor)));
+    BOOST_CHECK_EQUAL(executed_tasks, proof.query_proofs.size());
+    for (std::uint8_t bad_step : {std::uint8_t(0), std::uint8_t(32), std::uint8_t(255)}) {
+        auto corrupted_val = test_val_read;
+        std::get<1>(corrupted_val.value()).value().back().value() = bad_step;
+        BOOST_CHECK_THROW((nil::crypto3::marshalling::types::make_fri_proof<Endianness, FRI>(corrupted_val, batch_info, 1)),
+                          std::invalid_argument);
+
+        std::vector<std::uint8_t> corrupted_cv(corrupted_val.length(), 0x00);
+        auto corrupted_write_iter = corrupted_cv.begin();
+        BOOST_CHECK(corrupted_val.write(corrupted_write_iter, corrupted_cv.size()) == nil::marshalling::status_type::success);
+        typename FRI::proof_type corrupted_read;
+        auto corrupted_read_iter = corrupted_cv.cbegin();
+        BOOST_CHECK(nil::crypto3::marshalling::types::read_fri_proof<Endianness, FRI>(
+                corrupted_read_iter, corrupted_cv.size(), batch_info, corrupted_read) == nil::marshalling::status_type::invalid_msg_data);
+    }
+
+    typename FRI::proof_type direct_read;
+    auto direct_read_iter = cv.cbegin();
+    status = nil::crypto3::marshalling::types::read_fri_proof<Endianness, FRI>(
+            direct_read_iter, cv.size(), batch_info, direct_read);
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    BOOST_CHECK(direct_read_iter == cv.cend());
+    BOOST_CHECK(proof == direct_read);
+
+    direct_read_iter = cv.cbegin();
+    status = nil::crypto3::marshalling::types::read_fri_proof<Endianness, FRI>(
+            direct_read_iter, cv.size() - 1, batch_info, direct_read);
+    BOOST_CHECK(status != nil::marshalling::status_type::success);
+
+    nil::crypto3::marshalling::types::fri_proof_view<Endianness, FRI> view;
+    status = view.parse(cv.data(), cv.size(), batch_info);
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    BOOST_CHECK_EQUAL(view.lambda(), proof.query_proofs.size());
+    BOOST_CHECK(view.fri_roots() == proof.fri_roots);
+    BOOST_CHECK(view.proof_of_work() == proof.proof_of_work);
+    for (std::size_t i = proof.query_proofs.size(); i-- > 0;) {
+        typename FRI::query_proof_type query;
+        BOOST_CHECK(view.read_query(i, query) == nil::marshalling::status_type::success);
+        BOOST_CHECK(query == proof.query_proofs[i]);
+    }
+    typename FRI::query_proof_type out_of_range_query;
+    BOOST_CHECK(view.read_query(view.lambda(), out_of_range_query) ==
+                nil::marshalling::status_type::invalid_msg_data);
+    typename FRI::proof_type view_read;
+    BOOST_CHECK(view.read_proof(view_read) == nil::marshalling::status_type::success);
+    BOOST_CHECK(proof == view_read);
+    BOOST_CHECK(view.parse(cv.data(), cv.size() - 1, batch_info) != nil::marshalling::status_type::success);
+
+    auto filled_multiproof = nil::crypto3::marshalling::types::fill_fri_proof_multiproof<Endianness, FRI>(
+            proof, batch_info, params);
+    BOOST_CHECK(filled_multiproof.length() <= filled_proof.length());
+    std::vector<std::uint8_t> multiproof_cv(filled_multiproof.length(), 0x00);
+    auto multiproof_write_iter = multiproof_cv.begin();
+    status = filled_multiproof.write(multiproof_write_iter, multiproof_cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+
+    typename nil::crypto3::marshalling::types::fri_proof_multiproof<TTypeBase, FRI>::type multiproof_read;
+    auto multiproof_read_iter = multiproof_cv.begin();
+    status = multiproof_read.read(multiproof_read_iter, multiproof_cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    BOOST_CHECK(proof == (nil::crypto3::marshalling::types::make_fri_proof_multiproof<Endianness, FRI>(
+            multiproof_read, batch_info)));
 }
 
 BOOST_FIXTURE_TEST_SUITE(marshalling_fri_proof_elements, zk::test_tools::random_test_initializer<algebra::curves::bls12<381>::scalar_field_type>)
@@ -416,6 +495,158 @@ BOOST_FIXTURE_TEST_SUITE(marshalling_fri_proof_elements, zk::test_tools::random_
         );
         test_fri_proof<Endianness, FRI>(proof, batch_info, fri_params);
     }
+
+    BOOST_AUTO_TEST_CASE(fri_multiproof_shared_trees_test){
+        nil::crypto3::marshalling::types::batch_info_type batch_info;
+        batch_info[0] = 1;
+        batch_info[1] = 5;
+        batch_info[3] = 6;
+        batch_info[4] = 3;
+
+        typename FRI::params_type fri_params (
+            1, 11, lambda, 4
+        );
+
+        auto proof = generate_random_fri_proof<FRI>(
+                2, 5,
+                fri_params.step_list,
+                lambda,
+                false,
+                batch_info,
+                alg_random_engines.template get_alg_engine<field_type>(),
+                generic_random_engine
+        );
+
+        // Real FRI proofs open every query against the same per-batch and per-round trees
+        std::size_t tree_depth = 8;
+        std::size_t leafs_number = 1 << tree_depth;
+        auto make_shared_tree = [&]() {
+            auto rdata = generate_random_data_for_merkle_tree(leafs_number, 32, generic_random_engine);
+            return containers::make_merkle_tree<typename FRI::merkle_tree_hash_type, FRI::m>(rdata.begin(), rdata.end());
+        };
+        for (const auto &it : batch_info) {
+            auto tree = make_shared_tree();
+            for (auto &query : proof.query_proofs) {
+                query.initial_proof[it.first].p = typename FRI::merkle_proof_type(tree, generic_random_engine() % leafs_number);
+            }
+        }
+        for (std::size_t r = 0; r < fri_params.step_list.size(); r++) {
+            auto tree = make_shared_tree();
+            for (auto &query : proof.query_proofs) {
+                query.round_proofs[r].p = typename FRI::merkle_proof_type(tree, generic_random_engine() % leafs_number);
+            }
+        }
+
+        auto filled_proof = nil::crypto3::marshalling::types::fill_fri_proof<Endianness, FRI>(proof, batch_info, fri_params);
+        auto filled_multiproof = nil::crypto3::marshalling::types::fill_fri_proof_multiproof<Endianness, FRI>(
+                proof, batch_info, fri_params);
+        std::size_t legacy_merkle_length =
+            std::get<4>(filled_proof.value()).length() + std::get<5>(filled_proof.value()).length();
+        std::size_t multiproof_merkle_length =
+            std::get<4>(filled_multiproof.value()).length() + std::get<5>(filled_multiproof.value()).length();
+        BOOST_TEST_MESSAGE("Merkle proofs: " << legacy_merkle_length << " bytes, multiproofs: "
+            << multiproof_merkle_length << " bytes");
+        BOOST_CHECK(multiproof_merkle_length * 10 <= legacy_merkle_length * 7);
+        BOOST_CHECK(filled_multiproof.length() < filled_proof.length());
+
+        std::vector<std::uint8_t> cv(filled_multiproof.length(), 0x00);
+        auto write_iter = cv.begin();
+        auto status = filled_multiproof.write(write_iter, cv.size());
+        BOOST_CHECK(status == nil::marshalling::status_type::success);
+
+        typename nil::crypto3::marshalling::types::fri_proof_multiproof<TTypeBase, FRI>::type test_val_read;
+        auto read_iter = cv.cbegin();
+        status = test_val_read.read(read_iter, cv.size());
+        BOOST_CHECK(status == nil::marshalling::status_type::success);
+        BOOST_CHECK(proof == (nil::crypto3::marshalling::types::make_fri_proof_multiproof<Endianness, FRI>(
+                test_val_read, batch_info)));
+    }
+
+    BOOST_AUTO_TEST_CASE(fri_compact_proof_test){
+        nil::crypto3::marshalling::types::batch_info_type batch_info;
+        batch_info[0] = 1;
+        batch_info[1] = 5;
+        batch_info[3] = 6;
+        batch_info[4] = 3;
+
+        typename FRI::params_type fri_params (
+            1, 11, lambda, 4
+        );
+
+        auto proof = generate_random_fri_proof<FRI>(
+                2, 5,
+                fri_params.step_list,
+                lambda,
+                false,
+                batch_info,
+                alg_random_engines.template get_alg_engine<field_type>(),
+                generic_random_engine
+        );
+
+        // A one-step fold of the previous round's first coset pair at a per-query point with a per-round challenge,
+        // (y0 + y1) / 2 + alpha * (y0 - y1) / (2 * x). The verifier recomputes it from the values it already has.
+        auto fold = [](std::size_t i, std::size_t r, const typename FRI::query_proof_type &query_proof) {
+            const auto &previous = query_proof.round_proofs[r - 1].y[0];
+            value_type x = value_type(i + 2);
+            value_type alpha = value_type(r + 7);
+            value_type two_inversed = value_type(2).inversed();
+            return (previous[0] + previous[1]) * two_inversed +
+                   alpha * (previous[0] - previous[1]) * (x * value_type(2)).inversed();
+        };
+        auto derivable_slot = [](std::size_t i, std::size_t r, const typename FRI::query_proof_type &query_proof)
+                -> std::optional<std::pair<std::size_t, std::size_t>> {
+            if (r == 0) {
+                return std::nullopt;
+            }
+            return std::make_pair(i % query_proof.round_proofs[r].y.size(), i % FRI::m);
+        };
+        for (std::size_t i = 0; i < proof.query_proofs.size(); i++) {
+            auto &query_proof = proof.query_proofs[i];
+            for (std::size_t r = 1; r < query_proof.round_proofs.size(); r++) {
+                auto slot = derivable_slot(i, r, query_proof);
+                query_proof.round_proofs[r].y[slot->first][slot->second] = fold(i, r, query_proof);
+            }
+        }
+
+        auto filled_proof = nil::crypto3::marshalling::types::fill_fri_proof<Endianness, FRI>(proof, batch_info, fri_params);
+        auto filled_compact = nil::crypto3::marshalling::types::fill_fri_proof_compact<Endianness, FRI>(
+                proof, batch_info, fri_params, derivable_slot);
+        BOOST_CHECK(filled_compact.length() < filled_proof.length());
+        std::vector<std::uint8_t> cv(filled_compact.length(), 0x00);
+        auto write_iter = cv.begin();
+        auto status = filled_compact.write(write_iter, cv.size());
+        BOOST_CHECK(status == nil::marshalling::status_type::success);
+
+        typename nil::crypto3::marshalling::types::fri_proof_compact<TTypeBase, FRI>::type test_val_read;
+        auto read_iter = cv.cbegin();
+        status = test_val_read.read(read_iter, cv.size());
+        BOOST_CHECK(status == nil::marshalling::status_type::success);
+        std::size_t derived_values_amount = 0;
+        auto derived_value = [&fold, &derived_values_amount](
+                std::size_t i, std::size_t r, const typename FRI::query_proof_type &query_proof) {
+            derived_values_amount++;
+            return fold(i, r, query_proof);
+        };
+        BOOST_CHECK(proof == (nil::crypto3::marshalling::types::make_fri_proof_compact<Endianness, FRI>(
+                test_val_read, batch_info, derivable_slot, derived_value)));
+        BOOST_CHECK_EQUAL(derived_values_amount, lambda * (fri_params.step_list.size() - 1));
+
+        // A compact encoding is not a fri_proof, and a tag other than the compact one is rejected
+        typename nil::crypto3::marshalling::types::fri_proof<TTypeBase, FRI>::type legacy_read;
+        read_iter = cv.cbegin();
+        BOOST_CHECK(legacy_read.read(read_iter, cv.size()) != nil::marshalling::status_type::success);
+        std::get<0>(test_val_read.value()).value() = 0;
+        BOOST_CHECK_THROW((nil::crypto3::marshalling::types::make_fri_proof_compact<Endianness, FRI>(
+                test_val_read, batch_info, derivable_slot, derived_value)), std::invalid_argument);
+
+        // Missing values are rejected rather than read past the end of the section
+        std::get<3>(filled_proof.value()).value().pop_back();
+        BOOST_CHECK_THROW((nil::crypto3::marshalling::types::make_fri_proof<Endianness, FRI>(filled_proof, batch_info)),
+                          std::invalid_argument);
+        std::get<3>(std::get<1>(filled_compact.value()).value()).value().pop_back();
+        BOOST_CHECK_THROW((nil::crypto3::marshalling::types::make_fri_proof_compact<Endianness, FRI>(
+                filled_compact, batch_info, derivable_slot, derived_value)), std::invalid_argument);
+    }
 BOOST_AUTO_TEST_SUITE_END()
 
 
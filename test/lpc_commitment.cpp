@@ -430,6 +430,47 @@ BOOST_FIXTURE_TEST_CASE(lpc_proof_test, zk::test_tools::random_test_initializer<
     test_lpc_proof<Endianness, lpc_scheme_type>(proof, fri_params);
 }
 
+BOOST_FIXTURE_TEST_CASE(lpc_preprocessed_data_test, zk::test_tools::random_test_initializer<field_type>) {
+    using namespace nil::crypto3::marshalling;
+
+    auto &rnd = alg_random_engines.template get_alg_engine<field_type>();
+    // Entries of different sizes, one of them large enough to be decoded in parallel.
+    typename lpc_scheme_type::preprocessed_data_type data;
+    const std::vector<std::pair<std::size_t, std::size_t>> entries = {{0, 3}, {1, 0}, {3, 17}, {5, 5000}};
+    for (const auto &[id, size] : entries) {
+        auto &values = data[id];
+        for (std::size_t i = 0; i < size; i++) {
+            values.push_back(rnd());
+        }
+    }
+
+    auto filled_data = types::fill_commitment_preprocessed_data<Endianness, lpc_scheme_type>(data);
+    BOOST_CHECK(data == (types::make_commitment_preprocessed_data<Endianness, lpc_scheme_type>(filled_data)));
+
+    auto filled_indexed = types::fill_commitment_preprocessed_data_indexed<Endianness, lpc_scheme_type>(data);
+    BOOST_CHECK(data == (types::make_commitment_preprocessed_data_indexed<Endianness, lpc_scheme_type>(filled_indexed)));
+    BOOST_CHECK(data == (types::make_commitment_preprocessed_data_indexed<Endianness, lpc_scheme_type>(filled_indexed, 4)));
+
+    std::vector<std::uint8_t> cv(filled_indexed.length(), 0x00);
+    auto write_iter = cv.begin();
+    auto status = filled_indexed.write(write_iter, cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+
+    types::commitment_preprocessed_data_view<Endianness, lpc_scheme_type> view;
+    BOOST_CHECK(view.parse(cv.data(), cv.size()) == nil::marshalling::status_type::success);
+    BOOST_CHECK_EQUAL(view.size(), data.size());
+    BOOST_CHECK(data == view.read());
+    BOOST_CHECK(data == view.read(4));
+    auto span = view.batch(3);
+    BOOST_CHECK_EQUAL(span.size(), data[3].size());
+    BOOST_CHECK(span[span.size() - 1] == data[3].back());
+    std::vector<value_type> batch_values;
+    view.batch(5).read(batch_values);
+    BOOST_CHECK(batch_values == data[5]);
+    BOOST_CHECK_THROW(view.batch(2), std::out_of_range);
+    BOOST_CHECK(view.parse(cv.data(), cv.size() - 1) != nil::marshalling::status_type::success);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(marshalling_real)
@@ -49,6 +49,7 @@
 #include <nil/crypto3/hash/poseidon.hpp>
 
 #include <nil/crypto3/marshalling/containers/types/merkle_proof.hpp>
+#include <nil/crypto3/marshalling/containers/types/merkle_multiproof.hpp>
 
 template<typename TIter>
 void print_hex_byteblob(std::ostream &os, TIter iter_begin, TIter iter_end, bool endl) {
@@ -146,6 +147,85 @@ void test_merkle_proof(std::size_t tree_depth) {
     BOOST_CHECK(status == nil::marshalling::status_type::success);
     merkle_proof_type constructed_val_read = types::make_merkle_proof<merkle_proof_type, Endianness>(test_val_read);
     BOOST_CHECK(proof == constructed_val_read);
+
+    auto filled_root = types::fill_merkle_node_value_fixed<merkle_proof_type, Endianness>(proof.root());
+    if constexpr (!nil::crypto3::algebra::is_field_element<typename Hash::word_type>::value) {
+        BOOST_CHECK_EQUAL(filled_root.length(), Hash::digest_bits / 8);
+    }
+    std::vector<std::uint8_t> root_cv(filled_root.length(), 0x00);
+    write_iter = root_cv.begin();
+    status = filled_root.write(write_iter, root_cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+
+    typename types::merkle_node_value_fixed<nil::marshalling::field_type<Endianness>, merkle_proof_type>::type
+        root_read;
+    read_iter = root_cv.begin();
+    status = root_read.read(read_iter, root_cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    BOOST_CHECK(proof.root() == (types::make_merkle_node_value_fixed<merkle_proof_type, Endianness>(root_read)));
+
+    auto filled_compact = types::fill_merkle_proof_compact<merkle_proof_type, Endianness>(proof);
+    BOOST_CHECK(filled_compact.length() < filled_merkle_proof.length());
+    std::vector<std::uint8_t> compact_cv(filled_compact.length(), 0x00);
+    write_iter = compact_cv.begin();
+    status = filled_compact.write(write_iter, compact_cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+
+    types::merkle_proof_compact<nil::marshalling::field_type<Endianness>, merkle_proof_type> compact_read;
+    read_iter = compact_cv.begin();
+    status = compact_read.read(read_iter, compact_cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    BOOST_CHECK(proof == (types::make_merkle_proof_compact<merkle_proof_type, Endianness>(compact_read)));
+}
+
+template<typename Endianness, typename Hash, std::size_t Arity, std::size_t LeafSize = 64>
+void test_merkle_multiproof(std::size_t tree_depth, std::size_t proofs_amount) {
+
+    using namespace nil::crypto3::marshalling;
+    using merkle_tree_type = nil::crypto3::containers::merkle_tree<Hash, Arity>;
+    using merkle_proof_type = nil::crypto3::containers::merkle_proof<Hash, Arity>;
+    using merkle_multiproof_marshalling_type =
+            types::merkle_multiproof<nil::marshalling::field_type<Endianness>, merkle_proof_type>;
+
+    std::size_t leafs_number = std::pow(Arity, tree_depth);
+    auto data = generate_random_data<std::uint8_t, LeafSize>(leafs_number);
+    merkle_tree_type tree;
+    if constexpr (nil::crypto3::algebra::is_field_element<typename Hash::word_type>::value) {
+        std::vector<
+            nil::crypto3::hashes::block_to_field_elements_wrapper<
+                typename Hash::word_type::field_type,
+                std::array<std::uint8_t, LeafSize>
+            >
+        > wrappers;
+        for (const auto& inner_containers : data) {
+            wrappers.emplace_back(inner_containers);
+        }
+        tree = nil::crypto3::containers::make_merkle_tree<Hash, Arity>(wrappers.begin(), wrappers.end());
+    } else {
+        tree = nil::crypto3::containers::make_merkle_tree<Hash, Arity>(data.begin(), data.end());
+    }
+
+    std::vector<merkle_proof_type> proofs;
+    std::size_t separate_length = 0;
+    for (std::size_t i = 0; i < proofs_amount; i++) {
+        proofs.emplace_back(tree, std::rand() % leafs_number);
+        separate_length += types::fill_merkle_proof<merkle_proof_type, Endianness>(proofs.back()).length();
+    }
+
+    auto filled_multiproof = types::fill_merkle_multiproof<merkle_proof_type, Endianness>(proofs);
+    BOOST_CHECK(filled_multiproof.length() < separate_length);
+    BOOST_CHECK(proofs == (types::make_merkle_multiproof<merkle_proof_type, Endianness>(filled_multiproof)));
+
+    std::vector<std::uint8_t> cv(filled_multiproof.length(), 0x00);
+    auto write_iter = cv.begin();
+    nil::marshalling::status_type status = filled_multiproof.write(write_iter, cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+
+    merkle_multiproof_marshalling_type test_val_read;
+    auto read_iter = cv.begin();
+    status = test_val_read.read(read_iter, cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    BOOST_CHECK(proofs == (types::make_merkle_multiproof<merkle_proof_type, Endianness>(test_val_read)));
 }
 
 BOOST_AUTO_TEST_SUITE(marshalling_merkle_proof_test_suite)
@@ -165,6 +245,7 @@ using HashTypes = boost::mpl::list<
         test_merkle_proof<nil::marshalling::option::big_endian, HashType, 2>(5);
         test_merkle_proof<nil::marshalling::option::big_endian, HashType, 2>(10);
         test_merkle_proof<nil::marshalling::option::big_endian, HashType, 2, 320>(15);
+        test_merkle_multiproof<nil::marshalling::option::big_endian, HashType, 2>(10, 40);
     }
 
 // Poseidon hash function supports only Arity 2.
@@ -181,6 +262,7 @@ using BlockHashTypes = boost::mpl::list<
     BOOST_AUTO_TEST_CASE_TEMPLATE(marshalling_merkle_proof_arity_4_test, HashType, BlockHashTypes) {
         test_merkle_proof<nil::marshalling::option::big_endian, HashType, 4>(5);
         test_merkle_proof<nil::marshalling::option::big_endian, HashType, 4>(10);
+        test_merkle_multiproof<nil::marshalling::option::big_endian, HashType, 4>(5, 40);
     }
 
     BOOST_AUTO_TEST_CASE_TEMPLATE(marshalling_merkle_proof_arity_5_test, HashType, BlockHashTypes) {
@@ -9,6 +9,9 @@
 #include <iomanip>
 #include <fstream>
 #include <algorithm>
+#include <limits>
+#include <set>
+#include <stdexcept>
 #include <regex>
 
 #include <nil/marshalling/status_type.hpp>
@@ -63,6 +66,7 @@
 #include <nil/crypto3/marshalling/zk/types/commitments/kzg.hpp>
 #include <nil/crypto3/marshalling/zk/types/commitments/lpc.hpp>
 #include <nil/crypto3/marshalling/zk/types/placeholder/common_data.hpp>
+#include <nil/crypto3/marshalling/zk/types/placeholder/common_data_cache.hpp>
 #include "./detail/circuits.hpp"
 
 
@@ -138,6 +142,28 @@ void test_placeholder_common_data(CommonDataType common_data, std::string folder
             test_val_read
     );
     BOOST_CHECK(common_data == constructed_val_read);
+
+    auto filled_rotations = nil::crypto3::marshalling::types::fill_columns_rotations_compact<Endianness>(
+        common_data.columns_rotations);
+    BOOST_CHECK(filled_rotations.length() < std::get<1>(filled_common_data.value()).length());
+    BOOST_CHECK(common_data.columns_rotations ==
+        (nil::crypto3::marshalling::types::make_columns_rotations_compact<
+            Endianness, typename CommonDataType::columns_rotations_type>(filled_rotations)));
+
+    nil::crypto3::marshalling::types::placeholder_common_data_cache<Endianness, CommonDataType> cache(1);
+    auto cached = cache.get(cv.data(), cv.size());
+    BOOST_CHECK(*cached == common_data);
+    BOOST_CHECK(cache.get(cv.data(), cv.size()) == cached);
+    BOOST_CHECK_EQUAL(cache.hits(), 1);
+    BOOST_CHECK_EQUAL(cache.misses(), 1);
+    auto key = cache.digest(cv.data(), cv.size());
+    key[0] ^= 1;
+    BOOST_CHECK(*cache.get(key, test_val_read) == common_data);
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+    BOOST_CHECK(cache.find(key) != nullptr);
+    BOOST_CHECK(cache.find(cache.digest(cv.data(), cv.size())) == nullptr);
+    BOOST_CHECK_THROW(cache.get(cv.data(), cv.size() / 2), std::invalid_argument);
+
     if(folder_name != "") {
         std::filesystem::create_directory(folder_name);
         std::ofstream out;
@@ -149,6 +175,49 @@ void test_placeholder_common_data(CommonDataType common_data, std::string folder
     }
 }
 
+template<typename CommitmentSchemeType>
+void test_commitment_params_extended(const typename CommitmentSchemeType::params_type &params) {
+    using Endianness = nil::marshalling::option::big_endian;
+    using TTypeBase = nil::marshalling::field_type<Endianness>;
+    using namespace nil::crypto3::marshalling;
+
+    auto filled_params = types::fill_commitment_params_extended<Endianness, CommitmentSchemeType>(params);
+    std::vector<std::uint8_t> cv(filled_params.length(), 0x00);
+    auto write_iter = cv.begin();
+    auto status = filled_params.write(write_iter, cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+
+    types::commitment_params_extended<TTypeBase, CommitmentSchemeType> test_val_read;
+    auto read_iter = cv.begin();
+    status = test_val_read.read(read_iter, cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    auto constructed_params = types::make_commitment_params<Endianness, CommitmentSchemeType>(
+        std::get<0>(test_val_read.value()));
+    BOOST_CHECK(constructed_params.D.size() == params.D.size());
+    BOOST_CHECK(constructed_params.step_list == params.step_list);
+
+    auto twiddles = types::make_commitment_params_twiddles<Endianness, CommitmentSchemeType>(test_val_read);
+    BOOST_CHECK_EQUAL(twiddles.size(), params.D[0]->m / 2);
+    BOOST_CHECK(twiddles[0] == CommitmentSchemeType::params_type::field_type::value_type::one());
+    if (twiddles.size() > 1) {
+        BOOST_CHECK(twiddles[1] == constructed_params.D[0]->get_unity_root());
+    }
+
+    types::commitment_params_twiddle_view<Endianness, CommitmentSchemeType> view;
+    BOOST_CHECK(view.parse(cv.data(), cv.size()) == nil::marshalling::status_type::success);
+    BOOST_CHECK_EQUAL(view.size(), twiddles.size());
+    for (std::size_t i = 0; i < twiddles.size(); i++) {
+        BOOST_CHECK(view.twiddle(i) == twiddles[i]);
+    }
+    for (std::size_t d = 0; d < params.D.size() && params.D[d]->m > 2; d++) {
+        BOOST_CHECK(view.domain_twiddle(d, 1) == params.D[d]->get_unity_root());
+    }
+    BOOST_CHECK_THROW(view.twiddle(twiddles.size()), std::out_of_range);
+    BOOST_CHECK_THROW(view.domain_twiddle(1, (twiddles.size() >> 1) + 1), std::out_of_range);
+    BOOST_CHECK_THROW(view.domain_twiddle(std::numeric_limits<std::size_t>::digits, 0), std::out_of_range);
+    BOOST_CHECK(view.parse(cv.data(), cv.size() - 1) != nil::marshalling::status_type::success);
+}
+
 BOOST_AUTO_TEST_SUITE(placeholder_circuit1_poseidon)
     using Endianness = nil::marshalling::option::big_endian;
     using TTypeBase = nil::marshalling::field_type<Endianness>;
@@ -217,6 +286,69 @@ BOOST_AUTO_TEST_CASE(prover_test) {
         test_placeholder_common_data<common_data_type>(lpc_preprocessed_public_data.common_data, "circuit1");
     else
         test_placeholder_common_data<common_data_type>(lpc_preprocessed_public_data.common_data);
+    test_commitment_params_extended<lpc_scheme_type>(fri_params);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(columns_rotations_compact_test_suite)
+    using Endianness = nil::marshalling::option::big_endian;
+    using TTypeBase = nil::marshalling::field_type<Endianness>;
+    using columns_rotations_type = std::vector<std::set<int>>;
+
+BOOST_AUTO_TEST_CASE(thousands_of_columns) {
+    using namespace nil::crypto3::marshalling;
+
+    columns_rotations_type columns_rotations(3000);
+    for (std::size_t i = 0; i < columns_rotations.size(); i++) {
+        switch (i % 4) {
+            case 0: columns_rotations[i] = {0}; break;
+            case 1: columns_rotations[i] = {-1, 0, 1}; break;
+            case 2: columns_rotations[i] = {-200, 0, 70000}; break;
+            default: break;
+        }
+    }
+
+    auto filled = types::fill_columns_rotations_compact<Endianness>(columns_rotations);
+    std::vector<std::uint8_t> cv(filled.length(), 0x00);
+    auto write_iter = cv.begin();
+    auto status = filled.write(write_iter, cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+
+    types::columns_rotations_compact<TTypeBase> test_val_read;
+    auto read_iter = cv.begin();
+    status = test_val_read.read(read_iter, cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    BOOST_CHECK(columns_rotations ==
+        (types::make_columns_rotations_compact<Endianness, columns_rotations_type>(test_val_read)));
+
+    test_val_read.value().pop_back();
+    BOOST_CHECK_THROW(
+        (types::make_columns_rotations_compact<Endianness, columns_rotations_type>(test_val_read)),
+        std::invalid_argument);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(domain_set_cache_test_suite)
+    using field_type = typename algebra::curves::pallas::base_field_type;
+
+BOOST_AUTO_TEST_CASE(domain_sets_are_shared) {
+    auto &cache = nil::crypto3::marshalling::detail::domain_set_cache<field_type>::instance();
+    cache.clear();
+
+    auto D = nil::crypto3::marshalling::detail::get_domain_set<field_type>(10, 5);
+    auto D_cached = nil::crypto3::marshalling::detail::get_domain_set<field_type>(10, 5);
+    auto D_expected = math::calculate_domain_set<field_type>(10, 5);
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+    BOOST_CHECK_EQUAL(D.size(), D_expected.size());
+    for (std::size_t i = 0; i < D.size(); i++) {
+        BOOST_CHECK(D[i] == D_cached[i]);
+        BOOST_CHECK_EQUAL(D[i]->m, D_expected[i]->m);
+        BOOST_CHECK(D[i]->get_unity_root() == D_expected[i]->get_unity_root());
+    }
+
+    auto D_other = nil::crypto3::marshalling::detail::get_domain_set<field_type>(10, 4);
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+    BOOST_CHECK_EQUAL(D_other.size(), 4);
 }
 BOOST_AUTO_TEST_SUITE_END()
 
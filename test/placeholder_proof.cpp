@@ -37,6 +37,8 @@
 #include <fstream>
 #include <filesystem>
 #include <algorithm>
+#include <iterator>
+#include <limits>
 
 #include <nil/marshalling/status_type.hpp>
 #include <nil/marshalling/field_type.hpp>
@@ -88,6 +90,8 @@
 #include <nil/crypto3/marshalling/zk/types/commitments/kzg.hpp>
 #include <nil/crypto3/marshalling/zk/types/commitments/lpc.hpp>
 #include <nil/crypto3/marshalling/zk/types/placeholder/proof.hpp>
+#include <nil/crypto3/marshalling/zk/types/placeholder/proof_batch.hpp>
+#include <nil/crypto3/marshalling/zk/types/placeholder/proof_size.hpp>
 
 #include <nil/crypto3/math/algorithms/unity_root.hpp>
 #include <nil/crypto3/math/polynomial/lagrange_interpolation.hpp>
@@ -218,18 +222,139 @@ void test_placeholder_proof(const ProofType &proof, const CommitmentParamsType&
     BOOST_CHECK(status == nil::marshalling::status_type::success);
     auto constructed_val_read = types::make_placeholder_proof<Endianness, ProofType>(test_val_read);
     BOOST_CHECK(proof == constructed_val_read);
+
+    using eval_storage_type = typename std::decay<decltype(proof.eval_proof.eval_proof.z)>::type;
+    const auto &z = proof.eval_proof.eval_proof.z;
+    auto filled_z = types::fill_eval_storage<Endianness, eval_storage_type>(z);
+    auto filled_z_varint = types::fill_eval_storage_varint<Endianness, eval_storage_type>(z);
+    BOOST_CHECK(filled_z_varint.length() <= filled_z.length());
+    std::vector<std::uint8_t> z_cv(filled_z_varint.length(), 0x00);
+    auto z_write_iter = z_cv.begin();
+    status = filled_z_varint.write(z_write_iter, z_cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    types::eval_storage_varint<TTypeBase, eval_storage_type> z_read;
+    auto z_read_iter = z_cv.begin();
+    status = z_read.read(z_read_iter, z_cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    BOOST_CHECK(z == (types::make_eval_storage_varint<Endianness, eval_storage_type>(z_read)));
+}
+
+template<typename Endianness, typename ProofType, typename CommitmentParamsType>
+void test_placeholder_proof_batch(const ProofType &proof, std::size_t proofs_amount, const CommitmentParamsType& params) {
+
+    using namespace nil::crypto3::marshalling;
+
+    using TTypeBase = nil::marshalling::field_type<Endianness>;
+    using value_type = typename ProofType::field_type::value_type;
+
+    // Proofs of one circuit share the layout but not the values
+    std::vector<ProofType> proofs(proofs_amount, proof);
+    for (std::size_t i = 1; i < proofs.size(); i++) {
+        proofs[i].eval_proof.challenge = proofs[i].eval_proof.challenge + value_type(i);
+        proofs[i].eval_proof.eval_proof.fri_proof.proof_of_work += i;
+        auto &final_polynomial = proofs[i].eval_proof.eval_proof.fri_proof.final_polynomial;
+        final_polynomial[0] = final_polynomial[0] + value_type(i);
+    }
+
+    auto filled_batch = types::fill_placeholder_proof_batch<Endianness, ProofType>(proofs, params, 0);
+    std::size_t separate_length = 0;
+    for (const auto &proof : proofs) {
+        separate_length += types::fill_placeholder_proof<Endianness, ProofType>(proof, params).length();
+    }
+    BOOST_CHECK(filled_batch.length() < separate_length);
+
+    std::vector<std::uint8_t> cv(filled_batch.length(), 0x00);
+    auto write_iter = cv.begin();
+    auto status = filled_batch.write(write_iter, cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+
+    types::placeholder_proof_batch<TTypeBase, ProofType> test_val_read;
+    auto read_iter = cv.begin();
+    status = test_val_read.read(read_iter, cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+
+    types::placeholder_proof_batch_reader<Endianness, ProofType> reader(test_val_read);
+    BOOST_CHECK_EQUAL(reader.size(), proofs.size());
+    BOOST_CHECK(reader.proof(proofs.size() - 1) == proofs.back());
+    BOOST_CHECK(proofs == reader.proofs(1));
+    BOOST_CHECK(proofs == (types::make_placeholder_proof_batch<Endianness, ProofType>(test_val_read, 0)));
+
+    // A layout whose FRI queries cannot fit in any entry is rejected before decoding
+    const auto &layout = reader.layout();
+    std::vector<std::uint8_t> layout_bytes;
+    auto out = std::back_inserter(layout_bytes);
+    nil::crypto3::marshalling::detail::write_varint(layout.commitment_batches.size(), out);
+    for (const auto batch : layout.commitment_batches) {
+        nil::crypto3::marshalling::detail::write_varint(batch, out);
+    }
+    nil::crypto3::marshalling::detail::write_varint(layout.batches.size(), out);
+    for (const auto &batch : layout.batches) {
+        nil::crypto3::marshalling::detail::write_varint(batch.first, out);
+        nil::crypto3::marshalling::detail::write_varint(batch.second, out);
+    }
+    for (const auto points : layout.points) {
+        nil::crypto3::marshalling::detail::write_varint(points, out);
+    }
+    nil::crypto3::marshalling::detail::write_varint(std::numeric_limits<std::uint64_t>::max() >> 1, out);
+    nil::crypto3::marshalling::detail::write_varint(layout.step_list.size(), out);
+    for (const auto step : layout.step_list) {
+        nil::crypto3::marshalling::detail::write_varint(step, out);
+    }
+    auto oversized_batch = test_val_read;
+    auto &oversized_layout = std::get<0>(oversized_batch.value()).value();
+    oversized_layout.clear();
+    for (const std::uint8_t byte : layout_bytes) {
+        oversized_layout.emplace_back(byte);
+    }
+    BOOST_CHECK_THROW((types::placeholder_proof_batch_reader<Endianness, ProofType>(oversized_batch)), std::invalid_argument);
+
+    // Proofs with different FRI query amounts or roots do not share one layout
+    std::vector<ProofType> mismatched_proofs = proofs;
+    mismatched_proofs.back().eval_proof.eval_proof.fri_proof.query_proofs.pop_back();
+    BOOST_CHECK_THROW((types::fill_placeholder_proof_batch<Endianness, ProofType>(mismatched_proofs, params, 0)),
+                      std::invalid_argument);
+    mismatched_proofs.back() = proofs.back();
+    mismatched_proofs.back().eval_proof.eval_proof.fri_proof.fri_roots.pop_back();
+    BOOST_CHECK_THROW((types::fill_placeholder_proof_batch<Endianness, ProofType>(mismatched_proofs, params, 0)),
+                      std::invalid_argument);
 }
 
 bool has_argv(std::string name){
     bool result = false;
     for (std::size_t i = 0; i < std::size_t(boost::unit_test::framework::master_test_suite().argc); i++) {
-        if (std::string(boost::unit_test::framework::master_test_suite().argv[i]) == "--print") {
+        if (std::string(boost::unit_test::framework::master_test_suite().argv[i]) == name) {
             result = true;
         }
     }
     return result;
 }
 
+template<typename Endianness, typename ProofType, typename CommitmentParamsType>
+void test_placeholder_proof_size_breakdown(const ProofType &proof, const CommitmentParamsType& params) {
+
+    using namespace nil::crypto3::marshalling;
+
+    auto filled_placeholder_proof = types::fill_placeholder_proof<Endianness, ProofType>(proof, params);
+    auto sizes = types::make_placeholder_proof_size_breakdown<Endianness, ProofType>(filled_placeholder_proof);
+    BOOST_CHECK_EQUAL(sizes.total(), filled_placeholder_proof.length());
+
+    if (has_argv("--print-sizes")) {
+        std::cout << boost::unit_test::framework::current_test_case().full_name() << " proof size breakdown:" << std::endl
+                  << "  commitments:           " << sizes.commitments << std::endl
+                  << "  challenge:             " << sizes.challenge << std::endl
+                  << "  z values:              " << sizes.z_values << std::endl
+                  << "  FRI roots:             " << sizes.fri_roots << std::endl
+                  << "  FRI step list:         " << sizes.fri_step_list << std::endl
+                  << "  initial values:        " << sizes.initial_values << std::endl
+                  << "  round values:          " << sizes.round_values << std::endl
+                  << "  initial Merkle proofs: " << sizes.initial_merkle_proofs << std::endl
+                  << "  round Merkle proofs:   " << sizes.round_merkle_proofs << std::endl
+                  << "  final polynomial:      " << sizes.final_polynomial << std::endl
+                  << "  proof of work:         " << sizes.proof_of_work << std::endl
+                  << "  total:                 " << sizes.total() << std::endl;
+    }
+}
+
 template<typename Endianness, typename PlaceholderParams>
 void print_placeholder_proof_with_params(
     const typename placeholder_public_preprocessor<typename PlaceholderParams::field_type, PlaceholderParams>::preprocessed_data_type &preprocessed_data,
@@ -348,6 +473,9 @@ BOOST_FIXTURE_TEST_CASE(proof_marshalling_test, test_tools::random_test_initiali
         );
     } else {
         test_placeholder_proof<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(lpc_proof, fri_params);
+        test_placeholder_proof_size_breakdown<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(lpc_proof, fri_params);
+        test_placeholder_proof_batch<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(
+            lpc_proof, 3, fri_params);
     }
     auto verifier_res = placeholder_verifier<field_type, lpc_placeholder_params_type>::process(
         lpc_preprocessed_public_data.common_data, lpc_proof, desc, constraint_system, lpc_scheme
@@ -442,6 +570,7 @@ BOOST_FIXTURE_TEST_CASE(proof_marshalling_test, test_tools::random_test_initiali
         print_public_input(desc.public_input_columns == 0? std::vector<typename field_type::value_type>({}):assignments.public_input(0), "circuit1/public_input.inp");
     } else {
         test_placeholder_proof<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(lpc_proof, fri_params);
+        test_placeholder_proof_size_breakdown<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(lpc_proof, fri_params);
     }
     auto verifier_res = placeholder_verifier<field_type, lpc_placeholder_params_type>::process(
         lpc_preprocessed_public_data.common_data, lpc_proof, desc, constraint_system, lpc_scheme
@@ -543,6 +672,7 @@ BOOST_FIXTURE_TEST_CASE(proof_marshalling_test, test_tools::random_test_initiali
         print_public_input(desc.public_input_columns == 0? std::vector<typename field_type::value_type>({}):assignments.public_input(0), "circuit2/public_input.inp");
     }else {
         test_placeholder_proof<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(lpc_proof, fri_params);
+        test_placeholder_proof_size_breakdown<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(lpc_proof, fri_params);
     }
 
     verifier_res = placeholder_verifier<field_type, lpc_placeholder_params_type>::process(
@@ -632,6 +762,9 @@ BOOST_FIXTURE_TEST_CASE(proof_marshalling_test, test_tools::random_test_initiali
         print_public_input(desc.public_input_columns == 0? std::vector<typename field_type::value_type>({}):assignments.public_input(0), "circuit3/public_input.inp");
     } else {
         test_placeholder_proof<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(proof, fri_params);
+        test_placeholder_proof_size_breakdown<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(proof, fri_params);
+        test_placeholder_proof_batch<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(
+            proof, 2, fri_params);
     }
 
     bool verifier_res = placeholder_verifier<field_type, lpc_placeholder_params_type>::process(
@@ -722,6 +855,7 @@ BOOST_FIXTURE_TEST_CASE(proof_marshalling_test, test_tools::random_test_initiali
         print_public_input(desc.public_input_columns == 0? std::vector<typename field_type::value_type>({}):assignments.public_input(0), "circuit4/public_input.inp");
     }else {
         test_placeholder_proof<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(proof, fri_params);
+        test_placeholder_proof_size_breakdown<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(proof, fri_params);
     }
 
     bool verifier_res = placeholder_verifier<field_type, lpc_placeholder_params_type>::process(
@@ -811,6 +945,7 @@ BOOST_FIXTURE_TEST_CASE(proof_marshalling_test100, test_tools::random_test_initi
         print_public_input(desc.public_input_columns == 0? std::vector<typename field_type::value_type>({}):assignments.public_input(0), "circuit5_chunk100/public_input.inp");
     }else {
         test_placeholder_proof<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(proof, fri_params);
+        test_placeholder_proof_size_breakdown<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(proof, fri_params);
     }
 
     bool verifier_res = placeholder_verifier<field_type, lpc_placeholder_params_type>::process(
@@ -867,6 +1002,7 @@ BOOST_FIXTURE_TEST_CASE(proof_marshalling_test, test_tools::random_test_initiali
         print_public_input(desc.public_input_columns == 0? std::vector<typename field_type::value_type>({}):assignments.public_input(0), "circuit5_chunk10/public_input.inp");
     }else {
         test_placeholder_proof<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(proof, fri_params);
+        test_placeholder_proof_size_breakdown<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(proof, fri_params);
     }
 
     bool verifier_res = placeholder_verifier<field_type, lpc_placeholder_params_type>::process(
@@ -956,6 +1092,7 @@ BOOST_FIXTURE_TEST_CASE(proof_marshalling_test, test_tools::random_test_initiali
         print_public_input(desc.public_input_columns == 0? std::vector<typename field_type::value_type>({}):assignments.public_input(0), "circuit6/public_input.inp");
     }else {
         test_placeholder_proof<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(proof, fri_params);
+        test_placeholder_proof_size_breakdown<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(proof, fri_params);
     }
     bool verifier_res = placeholder_verifier<field_type, lpc_placeholder_params_type>::process(
         preprocessed_public_data.common_data, proof, desc, constraint_system, lpc_scheme);
@@ -1042,6 +1179,7 @@ BOOST_FIXTURE_TEST_CASE(proof_marshalling_test, test_tools::random_test_initiali
         print_public_input(desc.public_input_columns == 0? std::vector<typename field_type::value_type>({}):assignments.public_input(0), "circuit7/public_input.inp");
     }else {
         test_placeholder_proof<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(proof, fri_params);
+        test_placeholder_proof_size_breakdown<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(proof, fri_params);
     }
     bool verifier_res = placeholder_verifier<field_type, lpc_placeholder_params_type>::process(
         preprocessed_public_data.common_data, proof, desc, constraint_system, lpc_scheme);
@@ -1096,6 +1234,7 @@ BOOST_FIXTURE_TEST_CASE(proof_marshalling_test10, test_tools::random_test_initia
         print_public_input(desc.public_input_columns == 0? std::vector<typename field_type::value_type>({}):assignments.public_input(0), "circuit7_chunk10/public_input.inp");
     }else {
         test_placeholder_proof<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(proof, fri_params);
+        test_placeholder_proof_size_breakdown<Endianness, placeholder_proof<field_type, lpc_placeholder_params_type>>(proof, fri_params);
     }
     bool verifier_res = placeholder_verifier<field_type, lpc_placeholder_params_type>::process(
         preprocessed_public_data.common_data, proof, desc, constraint_system, lpc_scheme);
@@ -1272,3 +1411,57 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(prover_test, F, TestFixtures) {
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(eval_storage_varint_test_suite)
+    using field_type = typename algebra::curves::pallas::base_field_type;
+    using eval_storage_type = nil::crypto3::zk::commitments::eval_storage<field_type>;
+    using Endianness = nil::marshalling::option::big_endian;
+
+BOOST_FIXTURE_TEST_CASE(more_than_255_polynomials, test_tools::random_test_initializer<field_type>) {
+    auto &alg_rnd = alg_random_engines.template get_alg_engine<field_type>();
+
+    eval_storage_type z;
+    z.set_batch_size(0, 300);
+    z.set_batch_size(1000, 2);
+    for (std::size_t i = 0; i < 300; i++) {
+        z.set_poly_points_number(0, i, 1 + i % 3);
+        for (std::size_t j = 0; j < 1 + i % 3; j++) {
+            z.set(0, i, j, alg_rnd());
+        }
+    }
+    for (std::size_t i = 0; i < 2; i++) {
+        z.set_poly_points_number(1000, i, 400);
+        for (std::size_t j = 0; j < 400; j++) {
+            z.set(1000, i, j, alg_rnd());
+        }
+    }
+
+    auto filled_z = nil::crypto3::marshalling::types::fill_eval_storage_varint<Endianness, eval_storage_type>(z);
+    BOOST_CHECK(z == (nil::crypto3::marshalling::types::make_eval_storage_varint<Endianness, eval_storage_type>(filled_z)));
+
+    std::get<1>(filled_z.value()).value().pop_back();
+    BOOST_CHECK_THROW(
+        (nil::crypto3::marshalling::types::make_eval_storage_varint<Endianness, eval_storage_type>(filled_z)),
+        std::invalid_argument);
+}
+
+BOOST_FIXTURE_TEST_CASE(wrapping_points_numbers, test_tools::random_test_initializer<field_type>) {
+    using TTypeBase = nil::marshalling::field_type<Endianness>;
+    auto &alg_rnd = alg_random_engines.template get_alg_engine<field_type>();
+
+    // One batch of two polynomials whose points numbers 2^64 - 1 and 2 sum to 1 modulo 2^64
+    std::vector<std::uint8_t> metadata = {1, 0, 2};
+    nil::crypto3::marshalling::detail::write_varint(std::numeric_limits<std::uint64_t>::max(), std::back_inserter(metadata));
+    nil::crypto3::marshalling::detail::write_varint(2, std::back_inserter(metadata));
+
+    nil::crypto3::marshalling::types::eval_storage_varint<TTypeBase, eval_storage_type> filled_z;
+    std::get<0>(filled_z.value()).value().emplace_back(alg_rnd());
+    for (const std::uint8_t byte : metadata) {
+        std::get<1>(filled_z.value()).value().emplace_back(byte);
+    }
+    BOOST_CHECK_THROW(
+        (nil::crypto3::marshalling::types::make_eval_storage_varint<Endianness, eval_storage_type>(filled_z)),
+        std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
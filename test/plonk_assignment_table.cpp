@@ -7,6 +7,7 @@
 #include <regex>
 #include <fstream>
 #include <filesystem>
+#include <sstream>
 
 #include <nil/marshalling/status_type.hpp>
 #include <nil/marshalling/field_type.hpp>
@@ -19,9 +20,16 @@
 #include <nil/crypto3/algebra/curves/bls12.hpp>
 #include <nil/crypto3/algebra/fields/arithmetic_params/bls12.hpp>
 
+#include <nil/crypto3/hash/sha2.hpp>
+#include <nil/crypto3/hash/keccak.hpp>
+
 #include <nil/crypto3/random/algebraic_random_device.hpp>
 #include <nil/crypto3/marshalling/zk/types/plonk/variable.hpp>
 #include <nil/crypto3/marshalling/zk/types/plonk/assignment_table.hpp>
+#include <nil/crypto3/marshalling/zk/types/plonk/assignment_table_chunked.hpp>
+#include <nil/crypto3/marshalling/zk/types/plonk/assignment_table_columnar.hpp>
+#include <nil/crypto3/marshalling/zk/types/plonk/assignment_table_compact.hpp>
+#include <nil/crypto3/marshalling/zk/types/plonk/assignment_table_split.hpp>
 
 #include <nil/crypto3/zk/snark/systems/plonk/placeholder/detail/placeholder_policy.hpp>
 #include <nil/crypto3/zk/snark/systems/plonk/placeholder/params.hpp>
@@ -70,6 +78,13 @@ void test_assignment_table(std::size_t usable_rows, PlonkTable val, std::string
     BOOST_CHECK(val == table_desc_pair.second);
     BOOST_CHECK(usable_rows == table_desc_pair.first.usable_rows_amount);
 
+    for (std::size_t threads_amount : {1, 4, 64, 0}) {
+        auto parallel_table_desc_pair =
+            types::make_assignment_table<Endianness, PlonkTable>(filled_val, threads_amount);
+        BOOST_CHECK(val == parallel_table_desc_pair.second);
+        BOOST_CHECK(usable_rows == parallel_table_desc_pair.first.usable_rows_amount);
+    }
+
     std::vector<std::uint8_t> cv;
     cv.resize(filled_val.length(), 0x00);
 
@@ -84,6 +99,182 @@ void test_assignment_table(std::size_t usable_rows, PlonkTable val, std::string
     BOOST_CHECK(val == table_desc_pair.second);
     BOOST_CHECK(usable_rows == table_desc_pair.first.usable_rows_amount);
 
+    std::vector<std::uint8_t> direct_cv(types::assignment_table_length<Endianness>(val), 0x00);
+    BOOST_CHECK(direct_cv.size() == cv.size());
+    auto direct_write_iter = direct_cv.begin();
+    status = types::write_assignment_table<Endianness>(usable_rows, val, direct_write_iter, direct_cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    BOOST_CHECK(direct_cv == cv);
+
+    std::stringstream direct_stream;
+    status = types::write_assignment_table<Endianness>(usable_rows, val, direct_stream);
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    std::string direct_str = direct_stream.str();
+    BOOST_CHECK(std::equal(direct_str.begin(), direct_str.end(), cv.begin(), cv.end(),
+        [](char a, std::uint8_t b) { return std::uint8_t(a) == b; }));
+
+    using sha256_type = hashes::sha2<256>;
+    using keccak_type = hashes::keccak_1600<256>;
+    typename sha256_type::digest_type expected_digest = nil::crypto3::hash<sha256_type>(cv.begin(), cv.end());
+    BOOST_CHECK(expected_digest == (types::assignment_table_digest<Endianness, sha256_type>(usable_rows, val)));
+    std::stringstream digest_stream;
+    typename keccak_type::digest_type stream_digest;
+    status = types::write_assignment_table_with_digest<Endianness, keccak_type>(
+        usable_rows, val, digest_stream, stream_digest);
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    BOOST_CHECK(digest_stream.str() == direct_str);
+    BOOST_CHECK(stream_digest == static_cast<typename keccak_type::digest_type>(nil::crypto3::hash<keccak_type>(cv.begin(), cv.end())));
+
+    std::stringstream chunked_stream;
+    status = types::write_assignment_table_chunked<Endianness>(usable_rows, val, 3, chunked_stream);
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    auto chunked_table_desc_pair = types::make_assignment_table_chunked<Endianness, PlonkTable>(chunked_stream);
+    BOOST_CHECK(val == chunked_table_desc_pair.second);
+    BOOST_CHECK(usable_rows == chunked_table_desc_pair.first.usable_rows_amount);
+    {
+        // A header announcing a huge rows amount must fail on the missing chunks, not allocate up front.
+        const std::string chunked_str = chunked_stream.str();
+        std::vector<std::uint8_t> chunked_cv(chunked_str.begin(), chunked_str.end());
+        types::plonk_assignment_table_chunked_header<TTypeBase> header;
+        auto header_read_iter = chunked_cv.cbegin();
+        BOOST_CHECK(header.read(header_read_iter, chunked_cv.size()) == nil::marshalling::status_type::success);
+        std::get<5>(header.value()).value() = std::size_t(1) << 62;
+        auto header_write_iter = chunked_cv.begin();
+        BOOST_CHECK(header.write(header_write_iter, chunked_cv.size()) == nil::marshalling::status_type::success);
+        std::stringstream huge_stream(std::string(chunked_cv.begin(), chunked_cv.end()));
+        BOOST_CHECK_THROW((types::make_assignment_table_chunked<Endianness, PlonkTable>(huge_stream)),
+            std::invalid_argument);
+
+        // A consistent header and chunk prefix claiming 2^40 cells, followed by a few bytes only.
+        using size_marshalling_type = nil::marshalling::types::integral<TTypeBase, std::size_t>;
+        const std::size_t huge_rows = std::size_t(1) << 40;
+        types::plonk_assignment_table_chunked_header<TTypeBase> huge_header(std::make_tuple(
+            size_marshalling_type(1), size_marshalling_type(0), size_marshalling_type(0), size_marshalling_type(0),
+            size_marshalling_type(0), size_marshalling_type(huge_rows), size_marshalling_type(huge_rows)));
+        std::vector<std::uint8_t> huge_cv(huge_header.length() + 3 * size_marshalling_type().length() + 64, 0x00);
+        auto huge_write_iter = huge_cv.begin();
+        BOOST_CHECK(huge_header.write(huge_write_iter, huge_header.length()) == nil::marshalling::status_type::success);
+        for (const std::size_t value : {std::size_t(0), huge_rows, huge_rows}) {
+            size_marshalling_type filled_value(value);
+            BOOST_CHECK(filled_value.write(huge_write_iter, filled_value.length()) == nil::marshalling::status_type::success);
+        }
+        std::stringstream huge_chunk_stream(std::string(huge_cv.begin(), huge_cv.end()));
+        BOOST_CHECK_THROW((types::make_assignment_table_chunked<Endianness, PlonkTable>(huge_chunk_stream)),
+            std::invalid_argument);
+    }
+
+    auto filled_compact = types::fill_assignment_table_compact<Endianness, PlonkTable>(usable_rows, val);
+    BOOST_CHECK(filled_compact.length() <= cv.size());
+    for (const auto &filled_selector : std::get<9>(filled_compact.value()).value()) {
+        BOOST_CHECK(std::get<0>(filled_selector.value()).value() ==
+                    static_cast<std::uint8_t>(types::assignment_column_encoding::bits));
+    }
+    std::vector<std::uint8_t> compact_cv(filled_compact.length(), 0x00);
+    auto compact_write_iter = compact_cv.begin();
+    status = filled_compact.write(compact_write_iter, compact_cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    types::plonk_assignment_table_compact<TTypeBase, PlonkTable> compact_read;
+    auto compact_read_iter = compact_cv.begin();
+    status = compact_read.read(compact_read_iter, compact_cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    auto compact_table_desc_pair =
+        types::make_assignment_table_compact<Endianness, PlonkTable>(compact_read, val.rows_amount());
+    BOOST_CHECK(val == compact_table_desc_pair.second);
+    BOOST_CHECK(usable_rows == compact_table_desc_pair.first.usable_rows_amount);
+    auto compact_no_padding = compact_read;
+    std::get<4>(compact_no_padding.value()).value() = std::get<5>(compact_no_padding.value()).value();
+    BOOST_CHECK_THROW((types::make_assignment_table_compact<Endianness, PlonkTable>(compact_no_padding, val.rows_amount())),
+        std::invalid_argument);
+    {
+        // A small payload announcing a huge or odd rows amount must be rejected before the columns are padded.
+        auto patch_rows_amount = [&compact_read](std::size_t rows_amount) {
+            auto patched = compact_read;
+            std::get<5>(patched.value()).value() = rows_amount;
+            return patched;
+        };
+        BOOST_CHECK_THROW((types::make_assignment_table_compact<Endianness, PlonkTable>(
+            patch_rows_amount(std::size_t(1) << 40), val.rows_amount())), std::invalid_argument);
+        BOOST_CHECK_THROW((types::make_assignment_table_compact<Endianness, PlonkTable>(
+            patch_rows_amount(val.rows_amount() + 1), 2 * val.rows_amount())), std::invalid_argument);
+    }
+
+    types::plonk_assignment_table_fixed_part_cache<Endianness, PlonkTable> fixed_part_cache;
+    auto filled_fixed_part = types::fill_assignment_table_fixed_part<Endianness, PlonkTable>(val);
+    auto fixed_part_digest = fixed_part_cache.insert(filled_fixed_part);
+    BOOST_CHECK(fixed_part_digest ==
+        (types::assignment_table_fixed_part_digest<Endianness, PlonkTable>(filled_fixed_part)));
+    BOOST_CHECK(fixed_part_cache.insert(filled_fixed_part) == fixed_part_digest);
+    BOOST_CHECK(fixed_part_cache.size() == 1);
+    auto filled_instance =
+        types::fill_assignment_table_instance<Endianness, PlonkTable>(usable_rows, val, fixed_part_digest);
+    std::vector<std::uint8_t> instance_cv(filled_instance.length(), 0x00);
+    auto instance_write_iter = instance_cv.begin();
+    status = filled_instance.write(instance_write_iter, instance_cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    types::plonk_assignment_table_instance<TTypeBase, PlonkTable> instance_read;
+    auto instance_read_iter = instance_cv.begin();
+    status = instance_read.read(instance_read_iter, instance_cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    auto split_table_desc_pair = types::make_assignment_table_instance<Endianness, PlonkTable>(
+        instance_read, fixed_part_cache);
+    BOOST_CHECK(val == split_table_desc_pair.second);
+    BOOST_CHECK(usable_rows == split_table_desc_pair.first.usable_rows_amount);
+    fixed_part_cache.clear();
+    BOOST_CHECK_THROW((types::make_assignment_table_instance<Endianness, PlonkTable>(instance_read, fixed_part_cache)),
+        std::invalid_argument);
+
+    auto columnar_path = std::filesystem::temp_directory_path() / "plonk_assignment_table_columnar.tbl";
+    {
+        std::ofstream columnar_out(columnar_path, std::ios::binary);
+        status = types::write_assignment_table_columnar<Endianness>(usable_rows, val, columnar_out);
+        BOOST_CHECK(status == nil::marshalling::status_type::success);
+    }
+    {
+        types::plonk_assignment_table_mapped_file<Endianness, PlonkTable> mapped(columnar_path.string());
+        const auto &view = mapped.view();
+        BOOST_CHECK(usable_rows == view.table_description().usable_rows_amount);
+        for (std::size_t i = 0; i < val.witnesses_amount(); i++) {
+            BOOST_CHECK(view.witness(i).size() == val.rows_amount());
+            BOOST_CHECK(std::uintptr_t(view.witness(i).data()) % types::plonk_assignment_table_columnar_alignment == 0);
+            for (std::size_t j = 0; j < val.witness(i).size(); j++) {
+                BOOST_CHECK(view.witness(i)[j] == val.witness(i)[j]);
+            }
+        }
+        auto columnar_table_desc_pair = view.make_assignment_table();
+        BOOST_CHECK(val == columnar_table_desc_pair.second);
+    }
+    std::filesystem::remove(columnar_path);
+    {
+        // Headers are untrusted: a rows amount whose byte size wraps around must be rejected.
+        std::stringstream columnar_stream;
+        status = types::write_assignment_table_columnar<Endianness>(usable_rows, val, columnar_stream);
+        BOOST_CHECK(status == nil::marshalling::status_type::success);
+        const std::string columnar_str = columnar_stream.str();
+        std::vector<std::uint8_t> columnar_cv(columnar_str.begin(), columnar_str.end());
+        types::plonk_assignment_table_columnar_view<Endianness, PlonkTable> view;
+        BOOST_CHECK(view.parse(columnar_cv.data(), columnar_cv.size()) == nil::marshalling::status_type::success);
+
+        auto patch_header = [&columnar_cv](std::size_t usable_rows_amount, std::size_t rows_amount) {
+            std::vector<std::uint8_t> patched = columnar_cv;
+            types::plonk_assignment_table_columnar_header<TTypeBase> header;
+            auto header_read_iter = patched.cbegin();
+            BOOST_CHECK(header.read(header_read_iter, patched.size()) == nil::marshalling::status_type::success);
+            std::get<4>(header.value()).value() = usable_rows_amount;
+            std::get<5>(header.value()).value() = rows_amount;
+            auto header_write_iter = patched.begin();
+            BOOST_CHECK(header.write(header_write_iter, patched.size()) == nil::marshalling::status_type::success);
+            return patched;
+        };
+        auto wrapping = patch_header(0, std::size_t(1) << 60);
+        BOOST_CHECK(view.parse(wrapping.data(), wrapping.size()) != nil::marshalling::status_type::success);
+        auto no_padding = patch_header(val.rows_amount(), val.rows_amount());
+        BOOST_CHECK(view.parse(no_padding.data(), no_padding.size()) != nil::marshalling::status_type::success);
+        // A rejected header leaves the previously parsed table in place.
+        BOOST_CHECK_EQUAL(view.table_description().rows_amount, val.rows_amount());
+        BOOST_CHECK_EQUAL(view.table_description().usable_rows_amount, usable_rows);
+        BOOST_CHECK(val == view.make_assignment_table().second);
+    }
+
     if(folder_name != "") {
         std::filesystem::create_directory(folder_name);
         std::ofstream out;
@@ -500,3 +691,110 @@ BOOST_FIXTURE_TEST_CASE(assignment_table_marshalling_test, test_tools::random_te
         test_assignment_table<Endianness, typename policy_type::variable_assignment_type>(desc.usable_rows_amount, assignments);
 }
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(assignment_table_compact_encodings)
+    using Endianness = nil::marshalling::option::big_endian;
+    using TTypeBase = nil::marshalling::field_type<Endianness>;
+    using curve_type = algebra::curves::pallas;
+    using field_type = typename curve_type::base_field_type;
+    using value_type = typename field_type::value_type;
+    using table_type = plonk_assignment_table<field_type>;
+
+BOOST_FIXTURE_TEST_CASE(compact_column_encodings, test_tools::random_test_initializer<field_type>) {
+    const std::size_t rows_amount = 16;
+    std::vector<std::vector<value_type>> witnesses(4, std::vector<value_type>(rows_amount));
+    std::vector<std::vector<value_type>> selectors(1, std::vector<value_type>(rows_amount));
+    for (std::size_t i = 0; i < rows_amount; i++) {
+        witnesses[0][i] = value_type(i);
+        witnesses[1][i] = value_type(1000 + i);
+        witnesses[2][i] = value_type(i);
+        witnesses[3][i] = alg_random_engines.template get_alg_engine<field_type>()();
+        selectors[0][i] = value_type(i % 3 == 0 ? 1 : 0);
+    }
+    witnesses[2][5] = value_type(std::uint64_t(1) << 40);
+    table_type table(
+        typename table_type::private_table_type(witnesses),
+        typename table_type::public_table_type({}, {}, selectors));
+
+    auto filled_table = types::fill_assignment_table_compact<Endianness, table_type>(rows_amount - 2, table);
+    const auto &filled_witnesses = std::get<6>(filled_table.value()).value();
+    auto encoding = [](const auto &filled_column) {
+        return static_cast<types::assignment_column_encoding>(std::get<0>(filled_column.value()).value());
+    };
+    BOOST_CHECK(encoding(filled_witnesses[0]) == types::assignment_column_encoding::u8);
+    BOOST_CHECK(encoding(filled_witnesses[1]) == types::assignment_column_encoding::u16);
+    BOOST_CHECK(encoding(filled_witnesses[2]) == types::assignment_column_encoding::varint);
+    BOOST_CHECK(encoding(filled_witnesses[3]) == types::assignment_column_encoding::field);
+    BOOST_CHECK(encoding(std::get<9>(filled_table.value()).value()[0]) == types::assignment_column_encoding::bits);
+
+    std::vector<std::uint8_t> cv(filled_table.length(), 0x00);
+    auto write_iter = cv.begin();
+    auto status = filled_table.write(write_iter, cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    types::plonk_assignment_table_compact<TTypeBase, table_type> read_table;
+    auto read_iter = cv.begin();
+    status = read_table.read(read_iter, cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    auto table_desc_pair = types::make_assignment_table_compact<Endianness, table_type>(read_table, rows_amount);
+    BOOST_CHECK(table == table_desc_pair.second);
+}
+BOOST_AUTO_TEST_SUITE_END()
+
+template<typename PlonkTable, typename AlgRandomEngine>
+PlonkTable generate_random_assignment_table(
+    std::size_t witness_columns, std::size_t public_input_columns,
+    std::size_t constant_columns, std::size_t selector_columns,
+    std::size_t rows_amount, AlgRandomEngine &alg_rnd, std::mt19937 &rnd
+) {
+    using value_type = typename PlonkTable::field_type::value_type;
+    using column_type = std::vector<value_type>;
+
+    std::vector<column_type> witnesses(witness_columns, column_type(rows_amount));
+    for (auto &column : witnesses) {
+        for (auto &cell : column) cell = alg_rnd();
+    }
+    std::vector<column_type> public_inputs(public_input_columns, column_type(rows_amount));
+    for (auto &column : public_inputs) {
+        for (std::size_t i = 0; i < rows_amount / 2; i++) column[i] = alg_rnd();
+    }
+    std::vector<column_type> constants(constant_columns, column_type(rows_amount));
+    for (auto &column : constants) {
+        for (auto &cell : column) cell = value_type(rnd() % 256);
+    }
+    std::vector<column_type> selectors(selector_columns, column_type(rows_amount));
+    for (auto &column : selectors) {
+        for (auto &cell : column) cell = value_type(rnd() % 2);
+    }
+    return PlonkTable(
+        typename PlonkTable::private_table_type(witnesses),
+        typename PlonkTable::public_table_type(public_inputs, constants, selectors)
+    );
+}
+
+BOOST_AUTO_TEST_SUITE(assignment_table_random)
+    using Endianness = nil::marshalling::option::big_endian;
+    using TTypeBase = nil::marshalling::field_type<Endianness>;
+    using curve_type = algebra::curves::pallas;
+    using field_type = typename curve_type::base_field_type;
+    using table_type = plonk_assignment_table<field_type>;
+
+BOOST_FIXTURE_TEST_CASE(direct_writer_random_table, test_tools::random_test_initializer<field_type>) {
+    std::mt19937 rnd(0);
+    const std::size_t rows_amount = 1 << 6;
+    const std::size_t usable_rows = rows_amount - 10;
+    auto table = generate_random_assignment_table<table_type>(
+        15, 2, 5, 10, rows_amount, alg_random_engines.template get_alg_engine<field_type>(), rnd);
+
+    auto filled_table = types::fill_assignment_table<Endianness, table_type>(usable_rows, table);
+    std::vector<std::uint8_t> cv(filled_table.length(), 0x00);
+    auto write_iter = cv.begin();
+    auto status = filled_table.write(write_iter, cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+
+    std::vector<std::uint8_t> direct_cv(types::assignment_table_length<Endianness>(table), 0x00);
+    auto direct_write_iter = direct_cv.begin();
+    status = types::write_assignment_table<Endianness>(usable_rows, table, direct_write_iter, direct_cv.size());
+    BOOST_CHECK(status == nil::marshalling::status_type::success);
+    BOOST_CHECK(direct_cv == cv);
+}
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,112 @@
+#define BOOST_TEST_MODULE crypto3_marshalling_plonk_assignment_table_allocations_test
+
+// Replaces the global operator new to count allocations, so it lives in its own
+// executable and the other marshalling tests keep the default allocator.
+
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+#include <nil/marshalling/field_type.hpp>
+#include <nil/marshalling/endianness.hpp>
+
+#include <nil/crypto3/algebra/curves/pallas.hpp>
+#include <nil/crypto3/algebra/fields/arithmetic_params/pallas.hpp>
+
+#include <nil/crypto3/marshalling/zk/types/plonk/assignment_table.hpp>
+
+#include <nil/crypto3/zk/snark/arithmetization/plonk/assignment.hpp>
+#include <nil/crypto3/zk/test_tools/random_test_initializer.hpp>
+
+using namespace nil::crypto3;
+using namespace nil::crypto3::marshalling;
+using namespace nil::crypto3::zk;
+using namespace nil::crypto3::zk::snark;
+
+// Counts global allocations while allocations_counting is set.
+std::atomic<bool> allocations_counting(false);
+std::atomic<std::size_t> allocations_amount(0);
+
+void *operator new(std::size_t size) {
+    if (allocations_counting) {
+        allocations_amount++;
+    }
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+BOOST_AUTO_TEST_SUITE(assignment_table_allocations)
+    using Endianness = nil::marshalling::option::big_endian;
+    using curve_type = algebra::curves::pallas;
+    using field_type = typename curve_type::base_field_type;
+    using value_type = typename field_type::value_type;
+    using column_type = std::vector<value_type>;
+    using table_type = plonk_assignment_table<field_type>;
+
+BOOST_FIXTURE_TEST_CASE(round_trip_allocations, test_tools::random_test_initializer<field_type>) {
+    std::mt19937 rnd(0);
+    const std::size_t rows_amount = 1 << 10;
+    const std::size_t witness_columns = 15;
+    auto &alg_rnd = alg_random_engines.template get_alg_engine<field_type>();
+
+    std::vector<column_type> table_witnesses(witness_columns, column_type(rows_amount));
+    for (auto &column : table_witnesses) {
+        for (auto &cell : column) cell = alg_rnd();
+    }
+    std::vector<column_type> selectors(10, column_type(rows_amount));
+    for (auto &column : selectors) {
+        for (auto &cell : column) cell = value_type(rnd() % 2);
+    }
+    table_type table(
+        typename table_type::private_table_type(table_witnesses),
+        typename table_type::public_table_type(
+            std::vector<column_type>(2, column_type(rows_amount)),
+            std::vector<column_type>(5, column_type(rows_amount)),
+            selectors)
+    );
+
+    // Filling a column group allocates its flat cell vector exactly once.
+    allocations_amount = 0;
+    allocations_counting = true;
+    auto filled_witnesses = types::fill_field_element_vector_from_columns_with_padding<value_type, Endianness>(
+        table.witnesses(), rows_amount, 0u);
+    allocations_counting = false;
+    BOOST_CHECK_EQUAL(allocations_amount.load(), std::size_t(1));
+
+    // Decoding allocates the outer vector and one buffer per column, nothing else.
+    allocations_amount = 0;
+    allocations_counting = true;
+    auto witnesses = types::make_field_element_columns_vector<value_type, Endianness>(
+        filled_witnesses, witness_columns, rows_amount);
+    allocations_counting = false;
+    BOOST_CHECK_EQUAL(allocations_amount.load(), witness_columns + 1);
+    BOOST_CHECK(witnesses == table.witnesses());
+
+    // The decoded buffers are handed over to the table as make_assignment_table does it: moved, not copied.
+    std::vector<const value_type *> column_buffers;
+    for (const auto &column : witnesses) {
+        column_buffers.push_back(column.data());
+    }
+    table_type moved_table(
+        typename table_type::private_table_type(std::move(witnesses)),
+        typename table_type::public_table_type(table.public_inputs(), table.constants(), table.selectors())
+    );
+    BOOST_CHECK(moved_table == table);
+    for (std::size_t i = 0; i < witness_columns; i++) {
+        BOOST_CHECK(moved_table.witness(i).data() == column_buffers[i]);
+    }
+}
+BOOST_AUTO_TEST_SUITE_END()